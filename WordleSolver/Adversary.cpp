@@ -0,0 +1,74 @@
+#include "Adversary.h"
+#include <chrono>
+#include <iostream>
+#include <numeric>
+
+namespace {
+    // orders the feedback by how much it gives away, a green counts more than any number of yellows
+    template <size_t N>
+    size_t hint_weight(basic_pattern_t<N> pattern) {
+        CharState states[N]{};
+        decode_pattern(pattern, states);
+        size_t weight = 0;
+        for (CharState state : states)
+            weight += state == CharState::Correct ? N + 1 : state == CharState::Misplaced;
+        return weight;
+    }
+}
+
+template <size_t N>
+BasicAdversary<N>::BasicAdversary(const BasicSolverContext<N>& ctx) : m_ctx(ctx), m_live(ctx.solutions.size()) {
+    std::iota(m_live.begin(), m_live.end(), candidate_t{0});
+}
+
+template <size_t N>
+basic_pattern_t<N> BasicAdversary<N>::answer(guess_t guess) {
+    m_partition.split(m_ctx.patterns, m_ctx.solutions, guess, m_live);
+    size_t best = 0;
+    size_t best_size = 0;
+    size_t best_weight = 0;
+    for (size_t p = 0; p < BasicPartition<N>::bucket_count; p++) {
+        const size_t size = m_partition.size(p);
+        if (size == 0 || size < best_size) continue;
+        const size_t weight = hint_weight<N>(static_cast<basic_pattern_t<N>>(p));
+        if (size > best_size || weight < best_weight) {
+            best = p;
+            best_size = size;
+            best_weight = weight;
+        }
+    }
+    auto group = m_partition.bucket(best);
+    m_live.assign(group.begin(), group.end());
+    return static_cast<basic_pattern_t<N>>(best);
+}
+
+template <size_t N>
+bool solve_adversarial_game(const BasicSolverContext<N>& ctx, GuessData& data, bool print_intermediate) {
+    const auto start = std::chrono::steady_clock::now();
+    AdversarialBoard<N> board{};
+    BasicSolver<N, multi_max_guesses> solver{ctx};
+    BasicAdversary<N> host{ctx};
+    while (!board.solved() && board.guesses() < board.max_guesses()) {
+        guess_t guess = solver.next_guess(board);
+        board.apply(guess, host.answer(guess));
+    }
+    data.latencies.push_back(std::chrono::steady_clock::now() - start);
+    const bool solved = board.solved();
+    data.add(board.guesses(), solved);
+    if (print_intermediate) {
+        board.print(solver);
+        if (solved) {
+            std::cout << "Cornered the host in " << board.guesses() << " guesses, the word was "
+                      << solver.history(board.guesses() - 1) << "\n\n";
+        } else {
+            std::cout << "Didn't corner the host in " << board.guesses() << " guesses, " << host.live().size()
+                      << " solutions left\n\n";
+        }
+    }
+    return solved;
+}
+
+#define WS_INSTANTIATE_ADVERSARY(N)                                                                                    \
+    template class BasicAdversary<N>;                                                                                  \
+    template bool solve_adversarial_game(const BasicSolverContext<N>&, GuessData&, bool);
+WS_FOR_EACH_WORD_SIZE(WS_INSTANTIATE_ADVERSARY)
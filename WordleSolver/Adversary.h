@@ -0,0 +1,32 @@
+#pragma once
+#include "Partition.h"
+#include "Solver.h"
+#include "Sweep.h"
+#include <span>
+#include <vector>
+
+// Adversarial mode (Absurdle): the host doesn't pick a solution up front. Every guess splits the solutions that are
+// still possible by the feedback they would give it, and the host answers with the feedback of the largest group, so
+// the game only ends once a single solution is left and gets guessed. Ties go to the feedback with the fewest greens,
+// then the fewest yellows.
+template <size_t N>
+class BasicAdversary {
+    const BasicSolverContext<N>& m_ctx;
+    std::vector<candidate_t> m_live;
+    BasicPartition<N> m_partition{};
+
+    public:
+    explicit BasicAdversary(const BasicSolverContext<N>& ctx);
+
+    // the solutions consistent with every answer so far, in solution order
+    std::span<const candidate_t> live() const noexcept { return m_live; }
+    // the feedback for the guess, the live solutions are narrowed to the ones giving it
+    basic_pattern_t<N> answer(guess_t guess);
+};
+
+// without a solution the game has no natural length, it gets the room of the multi-board games
+template <size_t N>
+using AdversarialBoard = BasicBoard<N, multi_max_guesses>;
+
+template <size_t N>
+bool solve_adversarial_game(const BasicSolverContext<N>& ctx, GuessData& data, bool print_intermediate);
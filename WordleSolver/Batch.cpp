@@ -0,0 +1,342 @@
+#include "Batch.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std::string_view_literals;
+
+namespace {
+    constexpr size_t batch_size = 4096;
+    // requests handed to a worker at a time
+    constexpr size_t requests_per_chunk = 64;
+    // batches in flight: the one being read, the one being solved and the one being written
+    constexpr size_t n_slots = 3;
+    constexpr size_t read_buffer_size = 1 << 16;
+    constexpr size_t max_output_line = 128;
+    // day, solution, guess count and every guess, space separated, plus the newline
+    static_assert(20 + 1 + PackedDictionary::word_size + 1 + 1 +
+                  Board::max_guesses() * (1 + PackedDictionary::word_size) + 1 <= max_output_line);
+
+    enum class RequestError : uint8_t { None, BadRequest, UnknownWord, DayOutOfRange, LineTooLong, Failed };
+
+    constexpr std::string_view error_reason(RequestError error) {
+        switch (error) {
+        case RequestError::BadRequest:
+            return "bad request"sv;
+        case RequestError::UnknownWord:
+            return "unknown word"sv;
+        case RequestError::DayOutOfRange:
+            return "day out of range"sv;
+        case RequestError::LineTooLong:
+            return "line too long"sv;
+        default:
+            return "failed"sv;
+        }
+    }
+
+    struct Request {
+        size_t day = 0;
+        Strategy strategy = Strategy::Heuristic;
+        RequestError error = RequestError::None;
+    };
+
+    // One batch: its requests and an output line for each, every line in its own fixed size cell so the workers can
+    // write them in any order. The cells are compacted in place right before the batch is written.
+    struct Slot {
+        std::vector<Request> requests = std::vector<Request>(batch_size);
+        std::vector<uint8_t> sizes = std::vector<uint8_t>(batch_size);
+        std::vector<char> text = std::vector<char>(batch_size * max_output_line);
+        size_t count = 0;
+
+        char* line(size_t i) { return text.data() + i * max_output_line; }
+
+        size_t compact() {
+            size_t size = 0;
+            for (size_t i = 0; i < count; i++) {
+                std::memmove(text.data() + size, line(i), sizes[i]);
+                size += sizes[i];
+            }
+            return size;
+        }
+    };
+
+    class LineReader {
+        std::FILE* m_in;
+        std::vector<char> m_buffer;
+        size_t m_begin = 0;
+        size_t m_end = 0;
+        bool m_eof = false;
+        // inside a line that didn't fit the buffer, the rest of it is dropped
+        bool m_skipping = false;
+
+        static std::string_view trim_cr(std::string_view line) {
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            return line;
+        }
+
+        public:
+        explicit LineReader(std::FILE* in) : m_in(in), m_buffer(read_buffer_size) {}
+
+        // next line without its terminator, false at the end of the input. A line longer than the buffer comes back
+        // empty with too_long set. The view is valid until the next call.
+        bool next(std::string_view& line, bool& too_long) {
+            too_long = false;
+            while (true) {
+                const char* data = m_buffer.data();
+                if (const void* nl = std::memchr(data + m_begin, '\n', m_end - m_begin)) {
+                    const size_t pos = static_cast<size_t>(static_cast<const char*>(nl) - data);
+                    line = trim_cr({data + m_begin, pos - m_begin});
+                    m_begin = pos + 1;
+                    if (m_skipping) {
+                        m_skipping = false;
+                        continue;
+                    }
+                    return true;
+                }
+                if (m_eof) {
+                    if (m_begin == m_end || m_skipping) return false;
+                    line = trim_cr({data + m_begin, m_end - m_begin});
+                    m_begin = m_end;
+                    return true;
+                }
+                if (m_begin == 0 && m_end == m_buffer.size()) {
+                    m_end = 0;
+                    if (!m_skipping) {
+                        m_skipping = true;
+                        too_long = true;
+                        line = {};
+                        return true;
+                    }
+                }
+                std::memmove(m_buffer.data(), data + m_begin, m_end - m_begin);
+                m_end -= m_begin;
+                m_begin = 0;
+                const size_t n = std::fread(m_buffer.data() + m_end, 1, m_buffer.size() - m_end, m_in);
+                m_end += n;
+                m_eof = n == 0;
+            }
+        }
+    };
+
+    using day_map = std::unordered_map<std::string_view, size_t>;
+
+    std::string_view next_token(std::string_view& line) {
+        const size_t begin = std::min(line.find_first_not_of(" \t"sv), line.size());
+        const size_t end = std::min(line.find_first_of(" \t"sv, begin), line.size());
+        std::string_view token = line.substr(begin, end - begin);
+        line.remove_prefix(end);
+        return token;
+    }
+
+    // days holds the first day of every solution word, n_days is the number of solutions
+    Request parse_request(std::string_view line, Strategy default_strategy, const day_map& days, size_t n_days) {
+        Request request{0, default_strategy, RequestError::None};
+        const std::string_view target = next_token(line);
+        const std::string_view strategy = next_token(line);
+        if (!next_token(line).empty()) {
+            request.error = RequestError::BadRequest;
+        } else if (strategy == "heuristic"sv) {
+            request.strategy = Strategy::Heuristic;
+        } else if (strategy == "entropy"sv) {
+            request.strategy = Strategy::Entropy;
+        } else if (!strategy.empty()) {
+            request.error = RequestError::BadRequest;
+        }
+        if (request.error != RequestError::None) return request;
+        if (!target.empty() && target.find_first_not_of("0123456789"sv) == std::string_view::npos) {
+            auto res = std::from_chars(target.data(), target.data() + target.size(), request.day);
+            if (res.ec != std::errc{} || request.day >= n_days) request.error = RequestError::DayOutOfRange;
+        } else if (auto it = days.find(target); it != days.end()) {
+            request.day = it->second;
+        } else {
+            request.error = RequestError::UnknownWord;
+        }
+        return request;
+    }
+
+    char* append(char* out, std::string_view text) {
+        std::memcpy(out, text.data(), text.size());
+        return out + text.size();
+    }
+
+    // plays the day and writes its result line, returns the size of the line
+    size_t play(const SolverContext& ctx, size_t day, char* out) {
+        Board board{ctx.solutions, day, ctx.patterns};
+        Solver solver{ctx};
+        while (!board.solved() && board.guesses() < board.max_guesses())
+            board.guess(solver.next_guess(board));
+        char* end = out + max_output_line;
+        char* p = std::to_chars(out, end, day).ptr;
+        *p++ = ' ';
+        p = append(p, board.solution());
+        *p++ = ' ';
+        if (board.solved()) {
+            p = std::to_chars(p, end, board.guesses()).ptr;
+        } else {
+            *p++ = 'X';
+        }
+        for (size_t i = 0; i < board.guesses(); i++) {
+            *p++ = ' ';
+            p = append(p, solver.history(i));
+        }
+        *p++ = '\n';
+        return static_cast<size_t>(p - out);
+    }
+
+    // "error <reason>", cut to fit the line
+    size_t write_error(std::string_view reason, char* out) {
+        constexpr auto prefix = "error "sv;
+        char* p = append(out, prefix);
+        p = append(p, reason.substr(0, max_output_line - prefix.size() - 1));
+        *p++ = '\n';
+        return static_cast<size_t>(p - out);
+    }
+}
+
+BatchStats run_batch(std::FILE* in, std::FILE* out, ThreadPool& pool, Strategy default_strategy,
+                     const std::function<const SolverContext&(Strategy)>& context) {
+    std::array<const SolverContext*, 2> contexts{};
+    contexts[static_cast<size_t>(default_strategy)] = &context(default_strategy);
+    const auto solutions = contexts[static_cast<size_t>(default_strategy)]->solutions;
+    day_map days{};
+    days.reserve(solutions.size());
+    for (size_t i = 0; i < solutions.size(); i++)
+        days.emplace(solutions[i], i);
+
+    std::vector<Slot> slots(n_slots);
+    std::mutex mutex{};
+    std::condition_variable wake{};
+    // batches parsed, solved and written so far
+    size_t parsed = 0;
+    size_t filled = 0;
+    size_t written = 0;
+    bool input_done = false;
+    bool done = false;
+    bool write_failed = false;
+
+    // writes the batches in order as they're filled, while the next ones are solved
+    std::jthread writer{[&] {
+        for (size_t k = 0;; k++) {
+            {
+                std::unique_lock lock{mutex};
+                wake.wait(lock, [&] { return filled > k || done; });
+                if (filled == k) return;
+            }
+            Slot& slot = slots[k % n_slots];
+            const size_t size = slot.compact();
+            const bool ok = std::fwrite(slot.text.data(), 1, size, out) == size;
+            {
+                std::scoped_lock lock{mutex};
+                written = k + 1;
+                write_failed |= !ok;
+            }
+            wake.notify_all();
+            if (!ok) return;
+        }
+    }};
+
+    // reads and parses the next batch while the current one is solved, into a slot whose batch was written
+    std::jthread reader{[&] {
+        LineReader lines{in};
+        std::string_view line{};
+        bool too_long = false;
+        bool more = true;
+        for (size_t k = 0; more; k++) {
+            {
+                std::unique_lock lock{mutex};
+                wake.wait(lock, [&] { return k - written < n_slots || write_failed || done; });
+                if (write_failed || done) break;
+            }
+            Slot& slot = slots[k % n_slots];
+            slot.count = 0;
+            while (slot.count < batch_size && (more = lines.next(line, too_long))) {
+                if (too_long) {
+                    slot.requests[slot.count++] = Request{0, default_strategy, RequestError::LineTooLong};
+                } else if (line.find_first_not_of(" \t"sv) != std::string_view::npos) {
+                    slot.requests[slot.count++] = parse_request(line, default_strategy, days, solutions.size());
+                }
+            }
+            if (slot.count == 0) break;
+            {
+                std::scoped_lock lock{mutex};
+                parsed = k + 1;
+            }
+            wake.notify_all();
+        }
+        {
+            std::scoped_lock lock{mutex};
+            input_done = true;
+        }
+        wake.notify_all();
+    }};
+
+    // lets both threads finish, also when a context fails to build
+    struct Finish {
+        std::mutex& mutex;
+        std::condition_variable& wake;
+        bool& done;
+        ~Finish() {
+            {
+                std::scoped_lock lock{mutex};
+                done = true;
+            }
+            wake.notify_all();
+        }
+    };
+
+    BatchStats stats{};
+    {
+        const Finish finish{mutex, wake, done};
+        for (size_t k = 0;; k++) {
+            {
+                std::unique_lock lock{mutex};
+                wake.wait(lock, [&] { return parsed > k || input_done; });
+                if (parsed == k) break;
+            }
+            Slot& slot = slots[k % n_slots];
+            for (size_t i = 0; i < slot.count; i++) {
+                const auto& request = slot.requests[i];
+                auto& ctx = contexts[static_cast<size_t>(request.strategy)];
+                if (request.error == RequestError::None && ctx == nullptr) ctx = &context(request.strategy);
+            }
+            pool.parallel_for(0, slot.count, requests_per_chunk, [&](size_t, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    auto& request = slot.requests[i];
+                    char* text = slot.line(i);
+                    if (request.error != RequestError::None) {
+                        slot.sizes[i] = static_cast<uint8_t>(write_error(error_reason(request.error), text));
+                        continue;
+                    }
+                    try {
+                        slot.sizes[i] = static_cast<uint8_t>(
+                            play(*contexts[static_cast<size_t>(request.strategy)], request.day, text));
+                    } catch (const std::exception& e) {
+                        request.error = RequestError::Failed;
+                        slot.sizes[i] = static_cast<uint8_t>(write_error(e.what(), text));
+                    }
+                }
+            });
+            stats.requests += slot.count;
+            for (size_t i = 0; i < slot.count; i++)
+                stats.errors += slot.requests[i].error != RequestError::None;
+            {
+                std::scoped_lock lock{mutex};
+                filled = k + 1;
+            }
+            wake.notify_all();
+        }
+    }
+    reader.join();
+    writer.join();
+    if (write_failed || std::fflush(out) != 0) throw std::runtime_error("Failed to write the batch results");
+    return stats;
+}
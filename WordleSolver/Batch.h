@@ -0,0 +1,25 @@
+#pragma once
+#include "Solver.h"
+#include "ThreadPool.h"
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+
+// the batch and daemon requests only pick between the first two
+enum class Strategy { Heuristic, Entropy, Optimal };
+
+struct BatchStats {
+    size_t requests = 0;
+    size_t errors = 0;
+};
+
+// Streaming mode: reads one request per line from in, a day index or a solution word optionally followed by the
+// strategy ("heuristic" or "entropy", default_strategy otherwise), and writes one line per request to out, in input
+// order:
+//     <day> <solution> <guesses, X if not solved> <guess>...
+// or "error <reason>" for a request that can't be played. Empty lines are skipped.
+// Requests are solved in batches on the pool while the next batch is read and the previous ones are written, each on
+// its own thread. context(strategy) is only called from the calling thread, once per strategy, the first time a
+// request needs it.
+BatchStats run_batch(std::FILE* in, std::FILE* out, ThreadPool& pool, Strategy default_strategy,
+                     const std::function<const SolverContext&(Strategy)>& context);
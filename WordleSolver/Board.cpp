@@ -1,40 +1,46 @@
 #include "Board.h"
+#include "PatternMatrix.h"
 #include "Solver.h"
 #ifdef _WIN32
 #include <Windows.h>
 #endif
 #include <algorithm>
+#include <cctype>
 #include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
 
-Board::Board(const std::span<const std::string_view>& sols, size_t i) {
-    m_solution = sols[i];
+template <size_t N, size_t G>
+BasicBoard<N, G>::BasicBoard(const std::span<const std::string_view>& sols, size_t i, const PatternMatrix* patterns) :
+    m_solution(sols[i]), m_solution_code(pack_word<N>(sols[i])), m_solution_idx(i), m_patterns(patterns) {
+    if (m_patterns && N != PatternMatrix::word_size)
+        throw std::runtime_error("The pattern table only holds words of " + std::to_string(PatternMatrix::word_size) +
+                                 " letters");
 }
 
-void Board::guess(std::tuple<std::string_view, bool> word_special) {
-    const auto& [guessword, special] = word_special;
-    uint8_t marked[26]{};
-    uint8_t misplaced_letters = 0;
-    uint8_t known_letters = 0;
-    if (n_guess == max_guesses()) throw std::runtime_error("Maximum number of guesses reached");
-    for (char c : m_solution)
-        marked[c - 'a']++;
-
-    for (size_t i = 0; i < guessword.size(); i++) {
-        if (guessword[i] == m_solution[i]) {
-            m_board[n_guess][i] = CharState::Correct;
-            known_letters++;
-            marked[guessword[i] - 'a']--;
+template <size_t N, size_t G>
+void BasicBoard<N, G>::guess(guess_t word_special) {
+    const auto& [guessword, special, word_idx] = word_special;
+    if constexpr (N == PatternMatrix::word_size) {
+        if (m_patterns) {
+            apply(word_special, m_patterns->at(word_idx, m_solution_idx));
+            return;
         }
     }
+    apply(word_special, compute_packed_pattern<N>(pack_word<N>(guessword), m_solution_code));
+}
 
-    for (size_t i = 0; i < guessword.size(); i++) {
-        if (m_board[n_guess][i] == CharState::Correct) continue;
-        uint8_t& times_found = marked[guessword[i] - 'a'];
-        if (times_found > 0 && m_solution.find(guessword[i]) != std::string_view::npos) {
-            m_board[n_guess][i] = CharState::Misplaced;
-            misplaced_letters++;
-            times_found--;
-        }
+template <size_t N, size_t G>
+void BasicBoard<N, G>::apply(guess_t word_special, pattern_type pattern) {
+    const bool special = std::get<bool>(word_special);
+    if (n_guess == max_guesses()) throw std::runtime_error("Maximum number of guesses reached");
+    decode_pattern(pattern, m_board[n_guess]);
+    uint8_t known_letters = 0;
+    uint8_t misplaced_letters = 0;
+    for (CharState state : m_board[n_guess]) {
+        known_letters += state == CharState::Correct;
+        misplaced_letters += state == CharState::Misplaced;
     }
     if (!special) {
         m_new_info_obtained = known_letters * 2 + misplaced_letters > m_correct_letters * 2 + m_misplaced_letters;
@@ -46,59 +52,81 @@ void Board::guess(std::tuple<std::string_view, bool> word_special) {
     n_guess++;
 }
 
-bool Board::solved() const noexcept {
+template <size_t N, size_t G>
+bool BasicBoard<N, G>::solved() const noexcept {
     if (n_guess < 1) return false;
     return std::all_of(std::begin(m_board[n_guess - 1]), std::end(m_board[n_guess - 1]),
                        [](CharState state) { return state == CharState::Correct; });
 }
 
-void print_with_color(char c, CharState col) {
-    char upper_c = std::toupper(c);
-#ifdef _WIN32
-    HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
-    constexpr auto yellow = FOREGROUND_GREEN | FOREGROUND_RED;
-    constexpr auto green = FOREGROUND_GREEN;
-    constexpr auto red = FOREGROUND_RED;
-    switch (col) {
-    case CharState::Correct:
-        SetConsoleTextAttribute(out, green);
-        break;
-    case CharState::Wrong:
-        SetConsoleTextAttribute(out, red);
-        break;
-    case CharState::Misplaced:
-        SetConsoleTextAttribute(out, yellow);
-        break;
+namespace {
+    constexpr std::string_view reset_escape = "\033[0m";
+
+    constexpr std::string_view color_escape(CharState state) {
+        switch (state) {
+        case CharState::Correct:
+            return "\033[32m";
+        case CharState::Misplaced:
+            return "\033[33m";
+        case CharState::Wrong:
+            break;
+        }
+        return "\033[31m";
     }
-#else
-    constexpr auto yellow = "\033[33m";
-    constexpr auto green = "\033[32m";
-    constexpr auto red = "\033[31m";
-    switch (col) {
-    case CharState::Correct:
-        std::cout << green;
-        break;
-    case CharState::Wrong:
-        std::cout << red;
-        break;
-    case CharState::Misplaced:
-        std::cout << yellow;
-        break;
+
+    // appends the letters in upper case, current is the color the output is in and only changes are written
+    template <size_t N>
+    void render_row(std::string& out, std::string_view word, const CharState (&states)[N],
+                    std::optional<CharState>& current) {
+        for (size_t j = 0; j < N; j++) {
+            if (current != states[j]) {
+                out += color_escape(states[j]);
+                current = states[j];
+            }
+            out += static_cast<char>(std::toupper(static_cast<unsigned char>(word[j])));
+        }
     }
+}
+
+void write_output(std::string_view text) {
+#ifdef _WIN32
+    // Windows 10 consoles understand the same escapes once asked to, so a board is a single write there too instead of
+    // a SetConsoleTextAttribute call per letter
+    static const bool enabled = [] {
+        HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
+        DWORD mode = 0;
+        return GetConsoleMode(out, &mode) && SetConsoleMode(out, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    }();
+    (void)enabled;
 #endif
-    std::cout << upper_c;
+    std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
 }
 
-void Board::print(const Solver& solv) const {
+template <size_t N, size_t G>
+void BasicBoard<N, G>::render(const BasicSolver<N, G>& solv, std::string& out, BoardOutput output) const {
+    if (output == BoardOutput::Quiet) return;
+    std::optional<CharState> current{};
     for (size_t i = 0; i < n_guess; i++) {
-        for (size_t j = 0; j < array_size(m_board[i]); j++) {
-            print_with_color(solv.history(i)[j], m_board[i][j]);
+        if (output == BoardOutput::Compact && i > 0) out += ' ';
+        render_row(out, solv.history(i), m_board[i], current);
+        if (output == BoardOutput::Full) {
+            out += reset_escape;
+            out += '\n';
+            current.reset();
         }
-        std::cout << '\n';
-#ifdef _WIN32
-        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), FOREGROUND_BLUE | FOREGROUND_RED | FOREGROUND_GREEN);
-#else
-        std::cout << "\033[0m";
-#endif
     }
+    if (current) out += reset_escape;
 }
+
+template <size_t N, size_t G>
+void BasicBoard<N, G>::print(const BasicSolver<N, G>& solv) const {
+    thread_local std::string buffer{};
+    buffer.clear();
+    render(solv, buffer);
+    write_output(buffer);
+}
+
+#define WS_INSTANTIATE_BOARD(N)                                                                                        \
+    template class BasicBoard<N>;                                                                                      \
+    template class BasicBoard<N, multi_max_guesses>;
+WS_FOR_EACH_WORD_SIZE(WS_INSTANTIATE_BOARD)
@@ -1,35 +1,75 @@
 #pragma once
 #include "Common.h"
+#include "Pattern.h"
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <vector>
 #include <type_traits>
 #include <span>
 
 constexpr size_t static_max_guesses = 6;
+// room on the boards of the multi-board mode, whose guess budget grows with the number of boards
+constexpr size_t multi_max_guesses = 21;
 
-enum class CharState { Wrong = 0, Misplaced = 1, Correct = 2 };
+template <size_t N, size_t G = static_max_guesses>
+class BasicSolver;
+class PatternMatrix;
 
-class Solver;
+// how much of every game the sweeps print
+enum class BoardOutput {
+    // only the final stats
+    Quiet,
+    // a line per game: the solution, the guesses it took and the colored guesses
+    Compact,
+    // every board, a row per guess
+    Full,
+};
 
-class Board {
-    std::string_view m_solution;
-    CharState m_board[static_max_guesses][5]{};
+// guessed word, whether it was a special guess and its index in the dictionary the solver draws from
+using guess_t = std::tuple<std::string_view, bool, size_t>;
+
+// A game of words of N letters with at most G guesses. Instantiated for every word length from min_word_size to
+// max_word_size, so the loops over the letters of a row have a constant trip count.
+template <size_t N, size_t G = static_max_guesses>
+class BasicBoard {
+    std::string_view m_solution{};
+    basic_word_code_t<N> m_solution_code = 0;
+    size_t m_solution_idx = 0;
+    // only used with words of PatternMatrix::word_size letters
+    const PatternMatrix* m_patterns = nullptr;
+    CharState m_board[G][N]{};
     size_t n_guess = 0;
     uint8_t m_correct_letters = 0;
     uint8_t m_misplaced_letters = 0;
     bool m_new_info_obtained = false;
 
     public:
-    Board(const std::span<const std::string_view>& sols, size_t i);
+    BasicBoard(const std::span<const std::string_view>& sols, size_t i, const PatternMatrix* patterns = nullptr);
+    // board without a solution, feedback has to be given with apply
+    BasicBoard() = default;
 
     using type = decltype(m_board);
+    using pattern_type = basic_pattern_t<N>;
 
     std::string_view solution() const { return m_solution; }
-    void guess(std::tuple<std::string_view, bool> word_special);
+    size_t solution_index() const noexcept { return m_solution_idx; }
+    void guess(guess_t word_special);
+    void apply(guess_t word_special, pattern_type pattern);
     bool solved() const noexcept;
     size_t guesses() const noexcept { return n_guess; }
     static constexpr size_t max_guesses() noexcept { return type_array_size<type>(); };
+    static constexpr size_t word_size() noexcept { return N; }
     const auto& board() const noexcept { return m_board; }
     bool info_obtained() const noexcept { return m_new_info_obtained; }
-    void print(const Solver&) const;
-};
\ No newline at end of file
+    // appends the colored guesses to out, with an escape only where the color changes. Full mode ends every row
+    // with a newline, compact mode puts them on a single line without one
+    void render(const BasicSolver<N, G>&, std::string& out, BoardOutput output = BoardOutput::Full) const;
+    // renders into a buffer reused by the thread and writes it to stdout at once
+    void print(const BasicSolver<N, G>&) const;
+};
+
+using Board = BasicBoard<default_word_size>;
+
+// writes rendered boards to stdout in a single call, the console is set up for the color escapes first
+void write_output(std::string_view text);
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "CandidateIndex.h"
+#include <algorithm>
+#include <bit>
+
+namespace {
+    using block_t = uint64_t;
+    constexpr uint32_t all_letters = (1u << 26) - 1;
+
+    void and_with(std::span<block_t> live, const block_t* set) noexcept {
+        for (size_t i = 0; i < live.size(); i++)
+            live[i] &= set[i];
+    }
+
+    void and_not_with(std::span<block_t> live, const block_t* set) noexcept {
+        for (size_t i = 0; i < live.size(); i++)
+            live[i] &= ~set[i];
+    }
+
+    bool is_green(uint32_t banned) noexcept { return std::popcount(banned & all_letters) == 25; }
+}
+
+template <size_t N>
+BasicCandidateIndex<N>::BasicCandidateIndex(const BasicPackedDictionary<N>& dict) :
+    m_size(dict.size()), m_blocks((dict.size() + block_bits - 1) / block_bits), m_sets(n_sets * m_blocks) {
+    auto set_bit = [this](size_t set_idx, size_t word) {
+        m_sets[set_idx * m_blocks + word / block_bits] |= block_t{1} << (word % block_bits);
+    };
+    for (size_t i = 0; i < m_size; i++) {
+        for (size_t pos = 0; pos < word_size; pos++)
+            set_bit(dict.letters(pos)[i] * word_size + pos, i);
+        uint32_t mask = dict.masks()[i];
+        for (uint32_t letters = mask; letters != 0; letters &= letters - 1)
+            set_bit(26 * word_size + std::countr_zero(letters), i);
+        if (std::popcount(mask) == word_size) set_bit(26 * word_size + 26, i);
+    }
+}
+
+template <size_t N>
+void BasicCandidateIndex<N>::fill(std::span<block_t> live) const noexcept {
+    std::fill(live.begin(), live.end(), ~block_t{0});
+    if (m_size % block_bits != 0) live.back() = (block_t{1} << (m_size % block_bits)) - 1;
+}
+
+template <size_t N>
+void BasicCandidateIndex<N>::narrow(const BasicFilterConstraints<N>& constraints,
+                                    std::span<block_t> live) const noexcept {
+    for (uint32_t letters = constraints.forbidden & all_letters; letters != 0; letters &= letters - 1)
+        and_not_with(live, contains(std::countr_zero(letters)));
+    for (uint32_t letters = constraints.required & all_letters; letters != 0; letters &= letters - 1)
+        and_with(live, contains(std::countr_zero(letters)));
+    for (size_t pos = 0; pos < word_size; pos++) {
+        uint32_t banned = constraints.banned[pos] & all_letters;
+        if (is_green(banned)) {
+            and_with(live, at(std::countr_zero(~banned & all_letters), pos));
+        } else {
+            for (; banned != 0; banned &= banned - 1)
+                and_not_with(live, at(std::countr_zero(banned), pos));
+        }
+    }
+}
+
+template <size_t N>
+bool BasicCandidateIndex<N>::update(const BasicFilterConstraints<N>& from, const BasicFilterConstraints<N>& to,
+                                    std::span<block_t> live) const noexcept {
+    uint32_t loosened = (from.forbidden & ~to.forbidden) | (from.required & ~to.required);
+    for (size_t pos = 0; pos < word_size; pos++)
+        loosened |= from.banned[pos] & ~to.banned[pos];
+    if ((loosened & all_letters) != 0) {
+        fill(live);
+        narrow(to, live);
+        return true;
+    }
+    BasicFilterConstraints<N> added{};
+    added.forbidden = to.forbidden & ~from.forbidden;
+    added.required = to.required & ~from.required;
+    for (size_t pos = 0; pos < word_size; pos++) {
+        // a new green is a single AND with its position set rather than 25 AND NOT
+        bool new_green = is_green(to.banned[pos]) && !is_green(from.banned[pos]);
+        added.banned[pos] = new_green ? to.banned[pos] : to.banned[pos] & ~from.banned[pos];
+    }
+    narrow(added, live);
+    return false;
+}
+
+template <size_t N>
+size_t BasicCandidateIndex<N>::find_fresh(uint32_t used_letters, size_t from) const noexcept {
+    const block_t* distinct = distinct_letters();
+    for (size_t idx = from / block_bits; idx < m_blocks; idx++) {
+        block_t block = distinct[idx];
+        if (idx == from / block_bits) block &= ~block_t{0} << (from % block_bits);
+        for (uint32_t letters = used_letters & all_letters; letters != 0 && block != 0; letters &= letters - 1)
+            block &= ~contains(std::countr_zero(letters))[idx];
+        if (block != 0) return idx * block_bits + static_cast<size_t>(std::countr_zero(block));
+    }
+    return npos;
+}
+
+template <size_t N>
+size_t BasicCandidateIndex<N>::count(std::span<const block_t> live) noexcept {
+    size_t n = 0;
+    for (block_t block : live)
+        n += static_cast<size_t>(std::popcount(block));
+    return n;
+}
+
+template <size_t N>
+size_t BasicCandidateIndex<N>::find_next(std::span<const block_t> live, size_t from) noexcept {
+    size_t idx = from / block_bits;
+    if (idx >= live.size()) return npos;
+    block_t block = live[idx] & (~block_t{0} << (from % block_bits));
+    while (block == 0) {
+        if (++idx == live.size()) return npos;
+        block = live[idx];
+    }
+    return idx * block_bits + static_cast<size_t>(std::countr_zero(block));
+}
+
+#define WS_INSTANTIATE_INDEX(N) template class BasicCandidateIndex<N>;
+WS_FOR_EACH_WORD_SIZE(WS_INSTANTIATE_INDEX)
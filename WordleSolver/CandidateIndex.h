@@ -0,0 +1,55 @@
+#pragma once
+#include "FilterKernel.h"
+#include "PackedDictionary.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Inverted index over a dictionary: for every letter one bitset of the words having it at each position, one of the
+// words containing it anywhere, plus the words without repeated letters. Bit i of a set is dictionary word i.
+// FilterConstraints then narrow a live candidate set with a few word-wide AND / AND NOT. Every word has N letters.
+template <size_t N>
+class BasicCandidateIndex {
+    public:
+    using block_t = uint64_t;
+    static constexpr size_t block_bits = 64;
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    private:
+    static constexpr size_t word_size = N;
+    static constexpr size_t n_sets = 26 * word_size + 26 + 1;
+
+    size_t m_size;
+    size_t m_blocks;
+    std::vector<block_t> m_sets;
+
+    const block_t* set(size_t idx) const noexcept { return m_sets.data() + idx * m_blocks; }
+
+    public:
+    explicit BasicCandidateIndex(const BasicPackedDictionary<N>& dict);
+
+    size_t size() const noexcept { return m_size; }
+    size_t blocks() const noexcept { return m_blocks; }
+
+    const block_t* at(size_t letter, size_t pos) const noexcept { return set(letter * word_size + pos); }
+    const block_t* contains(size_t letter) const noexcept { return set(26 * word_size + letter); }
+    const block_t* distinct_letters() const noexcept { return set(26 * word_size + 26); }
+
+    // every word of the dictionary
+    void fill(std::span<block_t> live) const noexcept;
+    // removes from live every word the constraints reject
+    void narrow(const BasicFilterConstraints<N>& constraints, std::span<block_t> live) const noexcept;
+    // live already satisfies from, makes it satisfy to. Constraints that only got stricter are applied on top of live,
+    // if any got looser live is rebuilt from scratch. Returns true in the latter case.
+    bool update(const BasicFilterConstraints<N>& from, const BasicFilterConstraints<N>& to,
+                std::span<block_t> live) const noexcept;
+
+    // first word at or after from without repeated letters and without any of the given letters, npos if there's none
+    size_t find_fresh(uint32_t used_letters, size_t from) const noexcept;
+
+    static size_t count(std::span<const block_t> live) noexcept;
+    // first set bit at or after from, npos if there's none
+    static size_t find_next(std::span<const block_t> live, size_t from) noexcept;
+};
+
+using CandidateIndex = BasicCandidateIndex<default_word_size>;
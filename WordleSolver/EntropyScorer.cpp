@@ -0,0 +1,130 @@
+#include "EntropyScorer.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+// below this many candidates the histogram is reset by walking the candidates again instead of clearing it
+constexpr size_t sparse_histogram_limit = 256;
+// the sparse histogram counts up to that many candidates in 16 bits
+static_assert(sparse_histogram_limit <= UINT16_MAX);
+// with fewer candidates a turn is scored on the calling thread, waking the pool costs more than the scan
+constexpr size_t parallel_score_limit = 16;
+constexpr size_t probes_per_chunk = 256;
+
+EntropyScorer::EntropyScorer(const PatternMatrix& patterns, std::span<const WordView> words,
+                             std::span<const std::string_view> solutions, ThreadPool* pool) :
+    m_patterns(patterns), m_pool(pool), m_bucket_cost(solutions.size() + 1) {
+    if (patterns.rows() != words.size() || patterns.cols() != solutions.size())
+        throw std::runtime_error("Pattern table doesn't match the word lists");
+
+    m_solution_rows = PatternMatrix::solution_rows(words, solutions);
+
+    for (size_t k = 1; k < m_bucket_cost.size(); k++)
+        m_bucket_cost[k] = static_cast<double>(k) * std::log2(static_cast<double>(k));
+    for (auto& table : m_second_guess) {
+        for (auto& entry : table)
+            entry.store(npos32, std::memory_order_relaxed);
+    }
+
+    std::vector<candidate_t> all(solutions.size());
+    std::iota(all.begin(), all.end(), candidate_t{0});
+    m_opener = score_all(all, {});
+}
+
+EntropyScorer::ProbeScore EntropyScorer::score_range(std::span<const candidate_t> candidates,
+                                                     std::span<const uint64_t> allowed, size_t begin, size_t end,
+                                                     std::atomic<size_t>& perfect) const {
+    const size_t n = candidates.size();
+    const candidate_t* cand = candidates.data();
+    ProbeScore best{std::numeric_limits<double>::infinity(), false, end};
+    size_t scored = 0;
+
+    std::array<uint32_t, pattern_count> counts;
+    uint16_t hist[pattern_count]{};
+    for (size_t probe = begin; probe < end && probe < perfect.load(std::memory_order_relaxed); probe++) {
+        if (!allowed.empty() && ((allowed[probe / 64] >> (probe % 64)) & 1) == 0) continue;
+        scored++;
+        const PatternRow row = m_patterns.row(probe);
+        double cost = 0.0;
+        bool is_candidate = false;
+        if (n >= sparse_histogram_limit) {
+            count_feedback(row, candidates, counts);
+            for (size_t b = 0; b < pattern_count; b++)
+                cost += m_bucket_cost[counts[b]];
+            is_candidate = counts[solved_pattern] > 0;
+        } else {
+            for (size_t i = 0; i < n; i++)
+                hist[row[cand[i]]]++;
+            is_candidate = hist[solved_pattern] > 0;
+            for (size_t i = 0; i < n; i++) {
+                uint16_t& k = hist[row[cand[i]]];
+                cost += m_bucket_cost[k];
+                k = 0;
+            }
+        }
+        // on equal information a probe that might be the answer is strictly better
+        if (cost < best.cost || (cost == best.cost && is_candidate && !best.is_candidate)) {
+            best = {cost, is_candidate, probe};
+            // every candidate in its own bucket and a chance to win right away, nothing can beat this
+            if (cost == 0.0 && is_candidate) {
+                size_t first = perfect.load(std::memory_order_relaxed);
+                while (probe < first && !perfect.compare_exchange_weak(first, probe, std::memory_order_relaxed)) {}
+                break;
+            }
+        }
+    }
+    m_probes_scored.fetch_add(scored, std::memory_order_relaxed);
+    m_patterns_counted.fetch_add(scored * n, std::memory_order_relaxed);
+    return best;
+}
+
+size_t EntropyScorer::score_all(std::span<const candidate_t> candidates, std::span<const uint64_t> allowed) const {
+    const size_t rows = m_patterns.rows();
+    std::atomic<size_t> perfect{rows};
+    size_t best_probe = rows;
+    if (!m_pool || m_pool->size() < 2 || candidates.size() < parallel_score_limit) {
+        best_probe = score_range(candidates, allowed, 0, rows, perfect).probe;
+    } else {
+        // every worker keeps the best of its chunks, the order of ProbeScore makes the result the one of a single scan
+        std::vector<ProbeScore> best(m_pool->size(), ProbeScore{std::numeric_limits<double>::infinity(), false, rows});
+        m_pool->parallel_for(0, rows, probes_per_chunk, [&](size_t worker, size_t begin, size_t end) {
+            const ProbeScore score = score_range(candidates, allowed, begin, end, perfect);
+            if (score.better_than(best[worker])) best[worker] = score;
+        });
+        best_probe = std::ranges::min(best, [](const ProbeScore& a, const ProbeScore& b) {
+            return a.better_than(b);
+        }).probe;
+    }
+    // no probe allowed, the first word
+    return best_probe == rows ? 0 : best_probe;
+}
+
+size_t EntropyScorer::best_probe(std::span<const candidate_t> candidates, std::optional<pattern_t> opener_feedback,
+                                 std::span<const uint64_t> allowed) const {
+    if (candidates.empty()) throw std::runtime_error("No solution is consistent with the feedback");
+    // with 1 or 2 left guessing one of them is never worse than any probe
+    if (candidates.size() <= 2) return m_solution_rows[candidates.front()];
+    if (!opener_feedback.has_value()) return score_all(candidates, allowed);
+
+    auto& memo = m_second_guess[!allowed.empty()][*opener_feedback];
+    uint32_t probe = memo.load(std::memory_order_acquire);
+    if (probe == npos32) {
+        // racing threads compute the same value, so a plain store is enough
+        probe = static_cast<uint32_t>(score_all(candidates, allowed));
+        memo.store(probe, std::memory_order_release);
+    }
+    return probe;
+}
+
+void EntropyScorer::print_stats(size_t games, std::chrono::nanoseconds elapsed) const {
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    uint64_t probes = m_probes_scored.load(std::memory_order_relaxed);
+    uint64_t counted = m_patterns_counted.load(std::memory_order_relaxed);
+    std::cout << "Entropy engine: " << static_cast<double>(games) / seconds << " games/s, " << probes
+              << " probes scored, " << static_cast<double>(counted) / seconds << " patterns counted/s\n";
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "Partition.h"
+#include "PatternMatrix.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+class ThreadPool;
+
+// Picks the probe whose feedback splits the remaining solutions into the most even partition, i.e. the one with the
+// highest expected information. Shared read-only between games (and threads), per-game state lives in the Solver.
+class EntropyScorer {
+    static constexpr uint32_t npos32 = UINT32_MAX;
+
+    // the cost of a probe, ordered like a scan in dictionary order keeps them: the lowest cost, on a tie a probe that
+    // might be the answer, then the first one
+    struct ProbeScore {
+        double cost;
+        bool is_candidate;
+        size_t probe;
+
+        bool better_than(const ProbeScore& other) const noexcept {
+            if (cost != other.cost) return cost < other.cost;
+            if (is_candidate != other.is_candidate) return is_candidate;
+            return probe < other.probe;
+        }
+    };
+
+    const PatternMatrix& m_patterns;
+    // scores the probes of one call in chunks on all its threads, null scores them on the calling thread
+    ThreadPool* m_pool;
+    // solution index -> dictionary index
+    std::vector<uint32_t> m_solution_rows;
+    // k * log2(k) for a bucket of size k, the partition with the smallest sum is the one with the most information
+    std::vector<double> m_bucket_cost;
+    size_t m_opener = 0;
+    // best second guess for every feedback of the opener, filled lazily (npos32 until then). The second table is for
+    // hard mode, where the probe has to use the hints of the opener
+    mutable std::array<std::array<std::atomic<uint32_t>, pattern_count>, 2> m_second_guess;
+
+    mutable std::atomic<uint64_t> m_probes_scored = 0;
+    mutable std::atomic<uint64_t> m_patterns_counted = 0;
+
+    // the best probe in [begin, end), stops after a probe past perfect since no probe can beat one that's perfect
+    ProbeScore score_range(std::span<const candidate_t> candidates, std::span<const uint64_t> allowed, size_t begin,
+                           size_t end, std::atomic<size_t>& perfect) const;
+    size_t score_all(std::span<const candidate_t> candidates, std::span<const uint64_t> allowed) const;
+
+    public:
+    // With a pool the probes of every turn (and the opener) are scored on it, the pick doesn't depend on the number
+    // of threads. The pool can't be one whose workers call the scorer, they would wait on themselves.
+    EntropyScorer(const PatternMatrix& patterns, std::span<const WordView> words,
+                  std::span<const std::string_view> solutions, ThreadPool* pool = nullptr);
+
+    const PatternMatrix& patterns() const noexcept { return m_patterns; }
+    size_t opener() const noexcept { return m_opener; }
+
+    // dictionary index of the best probe for the given remaining solutions,
+    // opener_feedback is the feedback the opener got when picking the second guess.
+    // In hard mode allowed has bit i set for the dictionary words that are valid guesses, empty means all are
+    size_t best_probe(std::span<const candidate_t> candidates, std::optional<pattern_t> opener_feedback,
+                      std::span<const uint64_t> allowed = {}) const;
+
+    void print_stats(size_t games, std::chrono::nanoseconds elapsed) const;
+};
@@ -0,0 +1,95 @@
+#include "FilterKernel.h"
+#include "Simd.h"
+#include <bit>
+
+namespace {
+    constexpr size_t block_size = PackedDictionary::block_size;
+
+#if WS_HAS_X86
+    template <size_t word_size>
+    WS_TARGET_AVX2 size_t filter_words_avx2(const BasicPackedDictionary<word_size>& dict,
+                                            const BasicFilterConstraints<word_size>& constraints, size_t begin,
+                                            size_t end, uint32_t* out) {
+        // per position, 0xFF for every banned letter, split in two 16 entry tables for vpshufb
+        __m256i banned_lo[word_size];
+        __m256i banned_hi[word_size];
+        for (size_t pos = 0; pos < word_size; pos++) {
+            alignas(32) uint8_t table[32]{};
+            for (size_t l = 0; l < 26; l++)
+                table[l] = ((constraints.banned[pos] >> l) & 1) ? 0xFF : 0x00;
+            banned_lo[pos] = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table)));
+            banned_hi[pos] = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table + 16)));
+        }
+        const __m256i fifteen = _mm256_set1_epi8(15);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i forbidden = _mm256_set1_epi32(static_cast<int>(constraints.forbidden));
+        const __m256i required = _mm256_set1_epi32(static_cast<int>(constraints.required));
+        const uint32_t* masks = dict.masks();
+
+        size_t n = 0;
+        for (size_t block = begin - begin % block_size; block < end; block += block_size) {
+            // 32 words per instruction on the letter columns
+            __m256i banned = zero;
+            for (size_t pos = 0; pos < word_size; pos++) {
+                __m256i letters = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dict.letters(pos) + block));
+                __m256i high = _mm256_cmpgt_epi8(letters, fifteen);
+                __m256i hit = _mm256_blendv_epi8(_mm256_shuffle_epi8(banned_lo[pos], letters),
+                                                 _mm256_shuffle_epi8(banned_hi[pos], letters), high);
+                banned = _mm256_or_si256(banned, hit);
+            }
+            uint32_t pass = ~static_cast<uint32_t>(_mm256_movemask_epi8(banned));
+
+            // 8 words per instruction on the mask column
+            uint32_t mask_pass = 0;
+            for (size_t k = 0; k < block_size / 8; k++) {
+                __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks + block + k * 8));
+                __m256i no_forbidden = _mm256_cmpeq_epi32(_mm256_and_si256(mask, forbidden), zero);
+                __m256i has_required = _mm256_cmpeq_epi32(_mm256_and_si256(mask, required), required);
+                __m256i ok = _mm256_and_si256(no_forbidden, has_required);
+                mask_pass |= static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(ok))) << (k * 8);
+            }
+            pass &= mask_pass;
+
+            if (block < begin) pass &= ~0u << (begin - block);
+            if (end - block < block_size) pass &= (1u << (end - block)) - 1;
+            while (pass != 0) {
+                out[n++] = static_cast<uint32_t>(block + std::countr_zero(pass));
+                pass &= pass - 1;
+            }
+        }
+        return n;
+    }
+#endif
+}
+
+template <size_t N>
+size_t filter_words_scalar(const BasicPackedDictionary<N>& dict, const BasicFilterConstraints<N>& constraints,
+                           size_t begin, size_t end, uint32_t* out) {
+    const uint32_t* masks = dict.masks();
+    size_t n = 0;
+    for (size_t i = begin; i < end; i++) {
+        uint8_t letters[N];
+        for (size_t pos = 0; pos < N; pos++)
+            letters[pos] = dict.letters(pos)[i];
+        // branchless compaction: always write, only advance on a match
+        out[n] = static_cast<uint32_t>(i);
+        n += constraints.accepts(masks[i], letters);
+    }
+    return n;
+}
+
+template <size_t N>
+size_t filter_words(const BasicPackedDictionary<N>& dict, const BasicFilterConstraints<N>& constraints, size_t begin,
+                    size_t end, uint32_t* out) {
+#if WS_HAS_X86
+    if (cpu_has_avx2()) return filter_words_avx2(dict, constraints, begin, end, out);
+#endif
+    return filter_words_scalar(dict, constraints, begin, end, out);
+}
+
+#define WS_INSTANTIATE_FILTER(N)                                                                                      \
+    template size_t filter_words(const BasicPackedDictionary<N>&, const BasicFilterConstraints<N>&, size_t, size_t,  \
+                                 uint32_t*);                                                                          \
+    template size_t filter_words_scalar(const BasicPackedDictionary<N>&, const BasicFilterConstraints<N>&, size_t,   \
+                                        size_t, uint32_t*);
+WS_FOR_EACH_WORD_SIZE(WS_INSTANTIATE_FILTER)
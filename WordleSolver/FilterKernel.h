@@ -0,0 +1,31 @@
+#pragma once
+#include "PackedDictionary.h"
+#include <array>
+#include <cstdint>
+
+// Solver knowledge compiled down to 26-bit letter sets (bit i is the letter 'a' + i).
+// A green letter at a position is stored as every other letter being banned there.
+template <size_t N>
+struct BasicFilterConstraints {
+    uint32_t forbidden = 0;
+    uint32_t required = 0;
+    std::array<uint32_t, N> banned{};
+
+    bool accepts(uint32_t mask, const uint8_t (&letters)[N]) const noexcept {
+        bool ok = (mask & forbidden) == 0 && (mask & required) == required;
+        for (size_t pos = 0; pos < N; pos++)
+            ok &= ((banned[pos] >> letters[pos]) & 1) == 0;
+        return ok;
+    }
+};
+
+// Writes the indices in [begin, end) of the words that satisfy the constraints to out, in order, and returns how many
+// there are. out needs room for end - begin indices. Uses AVX2 (32 words per block) when the CPU supports it.
+template <size_t N>
+size_t filter_words(const BasicPackedDictionary<N>& dict, const BasicFilterConstraints<N>& constraints, size_t begin,
+                    size_t end, uint32_t* out);
+template <size_t N>
+size_t filter_words_scalar(const BasicPackedDictionary<N>& dict, const BasicFilterConstraints<N>& constraints,
+                           size_t begin, size_t end, uint32_t* out);
+
+using FilterConstraints = BasicFilterConstraints<default_word_size>;
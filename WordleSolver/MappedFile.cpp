@@ -0,0 +1,102 @@
+#include "MappedFile.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <atomic>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    auto fail = [&](const char* what) {
+        close();
+        throw std::runtime_error(std::string{what} + ' ' + path.string());
+    };
+#ifdef _WIN32
+    m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                         nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        fail("Couldn't open");
+    }
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(m_file, &size)) fail("Couldn't get the size of");
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size == 0) fail("Can't map empty file");
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping == nullptr) fail("Couldn't create a mapping for");
+    m_data = static_cast<const std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr) fail("Couldn't map");
+#else
+    m_fd = ::open(path.c_str(), O_RDONLY);
+    if (m_fd < 0) fail("Couldn't open");
+    struct stat st {};
+    if (::fstat(m_fd, &st) != 0) fail("Couldn't get the size of");
+    m_size = static_cast<size_t>(st.st_size);
+    if (m_size == 0) fail("Can't map empty file");
+    void* ptr = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, m_fd, 0);
+    if (ptr == MAP_FAILED) fail("Couldn't map");
+    m_data = static_cast<const std::byte*>(ptr);
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)),
+#ifdef _WIN32
+    m_file(std::exchange(other.m_file, nullptr)), m_mapping(std::exchange(other.m_mapping, nullptr)) {
+}
+#else
+    m_fd(std::exchange(other.m_fd, -1)) {
+}
+#endif
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+        m_file = std::exchange(other.m_file, nullptr);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+#else
+        m_fd = std::exchange(other.m_fd, -1);
+#endif
+    }
+    return *this;
+}
+
+void MappedFile::close() noexcept {
+#ifdef _WIN32
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    if (m_data) ::munmap(const_cast<std::byte*>(m_data), m_size);
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+std::filesystem::path unique_temp_path(const std::filesystem::path& path) {
+#ifdef _WIN32
+    const unsigned long pid = GetCurrentProcessId();
+#else
+    const unsigned long pid = static_cast<unsigned long>(::getpid());
+#endif
+    // the counter keeps the names of one process apart, the random part those of processes that reused a pid
+    static std::atomic<unsigned> counter{0};
+    static const unsigned seed = std::random_device{}();
+    auto tmp = path;
+    tmp += "." + std::to_string(pid) + "." + std::to_string(seed) + "." + std::to_string(counter.fetch_add(1)) + ".tmp";
+    return tmp;
+}
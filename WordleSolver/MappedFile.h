@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+// read-only memory mapping of a whole file, the mapping lives as long as the object
+class MappedFile {
+    const std::byte* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+
+    void close() noexcept;
+
+    public:
+    MappedFile() = default;
+    explicit MappedFile(const std::filesystem::path& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile() { close(); }
+
+    bool is_open() const noexcept { return m_data != nullptr; }
+    std::span<const std::byte> bytes() const noexcept { return {m_data, m_size}; }
+};
+
+// A name next to the path to write a file under before renaming it into place, made of the process id and a random
+// suffix so concurrent writers never share one
+std::filesystem::path unique_temp_path(const std::filesystem::path& path);
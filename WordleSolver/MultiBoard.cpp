@@ -0,0 +1,227 @@
+#include "MultiBoard.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <string>
+#include <stdexcept>
+
+namespace {
+    // a letter no guess had yet is worth as much as fitting a board with 8 candidates left, so the first guesses
+    // spread over new letters and the later ones close the boards
+    constexpr double fresh_letter_score = 1.0 / 8;
+}
+
+template <size_t N>
+BasicMultiSolver<N>::BasicMultiSolver(const BasicSolverContext<N>& ctx, size_t n_boards) :
+    m_ctx(ctx), m_fits(ctx.dict.size()) {
+    if (n_boards < min_boards || n_boards > max_boards)
+        throw std::runtime_error("A multi-board game has " + std::to_string(min_boards) + " to " +
+                                 std::to_string(max_boards) + " boards");
+    m_solvers.reserve(n_boards);
+    for (size_t i = 0; i < n_boards; i++)
+        m_solvers.emplace_back(ctx);
+}
+
+template <size_t N>
+guess_t BasicMultiSolver<N>::next_guess(std::span<const MultiBoard<N>> boards) {
+    std::array<size_t, max_boards> board_of{};
+    std::array<size_t, max_boards> counts{};
+    size_t n_active = 0;
+    for (size_t b = 0; b < boards.size(); b++) {
+        if (boards[b].solved()) continue;
+        if (boards[b].guesses() > 0) m_solvers[b].learn(boards[b]);
+        board_of[n_active++] = b;
+    }
+
+    // the boards every word fits, and the words fitting any board in dictionary order. Before the first guess every
+    // word fits every board the same, so only the new letters make a difference. The words guessed already can't be
+    // a solution anymore, they don't count as candidates left
+    const size_t dict_size = m_ctx.dict.size();
+    m_fitting.clear();
+    if (!m_history.empty()) {
+        if (m_ctx.index) {
+            using block_t = typename BasicCandidateIndex<N>::block_t;
+            std::array<std::span<const block_t>, max_boards> live{};
+            for (size_t k = 0; k < n_active; k++) {
+                live[k] = m_solvers[board_of[k]].candidates();
+                counts[k] = BasicCandidateIndex<N>::count(live[k]);
+                for (size_t idx : m_guessed) {
+                    constexpr size_t bits = BasicCandidateIndex<N>::block_bits;
+                    counts[k] -= (live[k][idx / bits] >> (idx % bits)) & 1;
+                }
+            }
+            for (size_t blk = 0; blk < m_ctx.index->blocks(); blk++) {
+                block_t any = 0;
+                for (size_t k = 0; k < n_active; k++)
+                    any |= live[k][blk];
+                for (; any != 0; any &= any - 1) {
+                    const size_t bit = static_cast<size_t>(std::countr_zero(any));
+                    mask_t fits = 0;
+                    for (size_t k = 0; k < n_active; k++)
+                        fits |= static_cast<mask_t>(((live[k][blk] >> bit) & 1) << k);
+                    const size_t word = blk * BasicCandidateIndex<N>::block_bits + bit;
+                    m_fits[word] = fits;
+                    m_fitting.push_back(static_cast<uint32_t>(word));
+                }
+            }
+        } else {
+            std::array<BasicFilterConstraints<N>, max_boards> constraints{};
+            for (size_t k = 0; k < n_active; k++)
+                constraints[k] = m_solvers[board_of[k]].compile_constraints();
+            constexpr size_t chunk_size = 256;
+            uint32_t survivors[chunk_size];
+            for (size_t start = 0; start < dict_size; start += chunk_size) {
+                const size_t end = std::min(start + chunk_size, dict_size);
+                std::fill(m_fits.begin() + start, m_fits.begin() + end, mask_t{0});
+                for (size_t k = 0; k < n_active; k++) {
+                    size_t n = filter_words(*m_ctx.packed, constraints[k], start, end, survivors);
+                    counts[k] += n;
+                    for (size_t i = 0; i < n; i++)
+                        m_fits[survivors[i]] |= static_cast<mask_t>(1u << k);
+                }
+                for (size_t i = start; i < end; i++) {
+                    if (m_fits[i] != 0) m_fitting.push_back(static_cast<uint32_t>(i));
+                }
+            }
+            for (size_t idx : m_guessed) {
+                for (mask_t fits = m_fits[idx]; fits != 0; fits &= fits - 1)
+                    counts[std::countr_zero(fits)]--;
+            }
+        }
+    }
+
+    uint32_t used = 0;
+    for (auto word : m_history)
+        used |= from_enum(construct_word_mask(word));
+    std::array<double, max_boards> weight{};
+    for (size_t k = 0; k < n_active; k++)
+        weight[k] = counts[k] == 0 ? 0.0 : 1.0 / static_cast<double>(counts[k]);
+    const uint32_t* masks = m_ctx.packed->masks();
+    auto fresh_score = [&](size_t i) { return fresh_letter_score * std::popcount(masks[i] & ~used); };
+    size_t best = dict_size;
+    double best_score = 0.0;
+    auto consider = [&](size_t i, double score) {
+        if ((score > best_score || (score == best_score && i < best)) &&
+            std::ranges::find(m_history, m_ctx.dict[i].word) == m_history.end()) {
+            best = i;
+            best_score = score;
+        }
+    };
+    for (uint32_t i : m_fitting) {
+        double score = fresh_score(i);
+        for (uint32_t fits = m_fits[i]; fits != 0; fits &= fits - 1)
+            score += weight[std::countr_zero(fits)];
+        consider(i, score);
+    }
+    // of the words fitting no board, only the first one with the most new letters can win. The index finds it if it
+    // has N of them, otherwise it has at most N - 1 and is only worth looking for if that can still win
+    size_t fresh = m_ctx.index ? m_ctx.index->find_fresh(used, 0) : BasicCandidateIndex<N>::npos;
+    if (fresh == BasicCandidateIndex<N>::npos && best_score <= fresh_letter_score * (m_ctx.index ? N - 1 : N)) {
+        size_t most = 0;
+        for (size_t i = 0; i < dict_size && most < N; i++) {
+            const size_t n_fresh = static_cast<size_t>(std::popcount(masks[i] & ~used));
+            if (n_fresh > most) {
+                most = n_fresh;
+                fresh = i;
+            }
+        }
+    }
+    if (fresh != BasicCandidateIndex<N>::npos) consider(fresh, fresh_score(fresh));
+    if (best == dict_size) throw std::runtime_error("No word in the dictionary fits the feedback");
+
+    const guess_t guess{m_ctx.dict[best].word, false, best};
+    for (size_t k = 0; k < n_active; k++)
+        m_solvers[board_of[k]].record(boards[board_of[k]], guess);
+    m_history.push_back(m_ctx.dict[best].word);
+    m_guessed.push_back(best);
+    return guess;
+}
+
+template <size_t N>
+bool solve_multi_game(const BasicSolverContext<N>& ctx, size_t n_boards, size_t day, GuessData& data,
+                      BoardOutput output, std::string& out) {
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<MultiBoard<N>> boards{};
+    boards.reserve(n_boards);
+    for (size_t i = 0; i < n_boards; i++)
+        boards.emplace_back(ctx.solutions, (day + i) % ctx.solutions.size(), ctx.patterns);
+    BasicMultiSolver<N> solver{ctx, n_boards};
+    auto all_solved = [&] { return std::ranges::all_of(boards, [](const auto& b) { return b.solved(); }); };
+    size_t n_guesses = 0;
+    while (!all_solved() && n_guesses < multi_guess_budget(n_boards)) {
+        guess_t guess = solver.next_guess(boards);
+        for (auto& board : boards) {
+            if (!board.solved()) board.guess(guess);
+        }
+        n_guesses++;
+    }
+    data.latencies.push_back(std::chrono::steady_clock::now() - start);
+    const bool solved = all_solved();
+    data.add(n_guesses, solved);
+    if (!solved) data.failed_days.push_back(day);
+    if (output == BoardOutput::Compact) {
+        for (size_t i = 0; i < n_boards; i++) {
+            if (i > 0) out += '+';
+            out += boards[i].solution();
+        }
+        out += ' ';
+        out += solved ? std::to_string(n_guesses) : "X";
+        out += '/';
+        out += std::to_string(multi_guess_budget(n_boards));
+        out += '\n';
+    } else if (output == BoardOutput::Full) {
+        for (size_t i = 0; i < n_boards; i++) {
+            out += "Board " + std::to_string(i + 1) + ", the word was ";
+            out += boards[i].solution();
+            out += '\n';
+            boards[i].render(solver.solver(i), out);
+        }
+        out += solved ? "Solved all " : "Didn't solve all ";
+        out += std::to_string(n_boards) + " boards in " + std::to_string(n_guesses) + " guesses\n\n";
+    }
+    return solved;
+}
+
+template <size_t N>
+GuessData solve_multi_loop(const BasicSolverContext<N>& ctx, size_t n_boards, size_t start, size_t end,
+                           BoardOutput output, ProgressSlot* progress) {
+    GuessData data{};
+    data.progress = progress;
+    std::string out{};
+    if (output != BoardOutput::Quiet) out.reserve(2 * output_batch_size);
+    for (size_t day = start; day < end; day++) {
+        solve_multi_game(ctx, n_boards, day, data, output, out);
+        if (out.size() >= output_batch_size) {
+            write_output(out);
+            out.clear();
+        }
+    }
+    // a quiet chunk of a parallel sweep has nothing to write
+    if (!out.empty()) write_output(out);
+    return data;
+}
+
+template <size_t N>
+GuessData solve_multi_loop_parallel(const BasicSolverContext<N>& ctx, size_t n_boards, size_t start, size_t end,
+                                    ThreadPool& pool, SweepProgress* progress) {
+    std::vector<GuessData> per_worker(pool.size());
+    pool.parallel_for(start, end, days_per_chunk, [&](size_t worker, size_t begin, size_t chunk_end) {
+        ProgressSlot* slot = progress ? &progress->slot(worker) : nullptr;
+        per_worker[worker].merge(solve_multi_loop(ctx, n_boards, begin, chunk_end, BoardOutput::Quiet, slot));
+    });
+    GuessData global_data{};
+    for (const auto& data : per_worker)
+        global_data.merge(data);
+    return global_data;
+}
+
+#define WS_INSTANTIATE_MULTI(N)                                                                                        \
+    template class BasicMultiSolver<N>;                                                                                \
+    template bool solve_multi_game(const BasicSolverContext<N>&, size_t, size_t, GuessData&, BoardOutput,              \
+                                   std::string&);                                                                      \
+    template GuessData solve_multi_loop(const BasicSolverContext<N>&, size_t, size_t, size_t, BoardOutput,             \
+                                        ProgressSlot*);                                                                \
+    template GuessData solve_multi_loop_parallel(const BasicSolverContext<N>&, size_t, size_t, size_t, ThreadPool&,    \
+                                                 SweepProgress*);
+WS_FOR_EACH_WORD_SIZE(WS_INSTANTIATE_MULTI)
@@ -0,0 +1,63 @@
+#pragma once
+#include "Solver.h"
+#include "Sweep.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Multi-board mode (Dordle, Quordle, Octordle...): every guess goes to all the boards that aren't solved yet, and
+// all of them have to be solved within one shared budget of guesses.
+constexpr size_t min_boards = 2;
+constexpr size_t max_boards = 16;
+
+// 7 guesses for 2 boards, 9 for 4, 13 for 8
+constexpr size_t multi_guess_budget(size_t n_boards) { return n_boards + 5; }
+static_assert(multi_guess_budget(max_boards) <= multi_max_guesses);
+
+template <size_t N>
+using MultiBoard = BasicBoard<N, multi_max_guesses>;
+
+// Picks the guess for all the boards in a single pass over the dictionary: every block of words goes through the
+// filter kernel once per unsolved board while it's in cache (or, with an index, every block of the boards' candidate
+// bitsets is merged), which leaves each word with the set of boards it could be the solution of. A word scores
+// 1 / (candidates left) for each of those boards, plus a bit for every letter no guess had yet, so the sole candidate
+// of a board always wins, words fitting several nearly solved boards come next and while the boards are still wide
+// open new letters do. Ties go to the best rated word.
+template <size_t N>
+class BasicMultiSolver {
+    using solver_type = BasicSolver<N, multi_max_guesses>;
+    using mask_t = uint16_t;
+    static_assert(sizeof(mask_t) * 8 >= max_boards);
+
+    const BasicSolverContext<N>& m_ctx;
+    // what is known about each board, fed the shared guesses
+    std::vector<solver_type> m_solvers{};
+    std::vector<std::string_view> m_history{};
+    // dictionary indices of m_history
+    std::vector<size_t> m_guessed{};
+    // per dictionary word, bit k is set if it fits the k-th unsolved board. Only valid for the words in m_fitting
+    std::vector<mask_t> m_fits;
+    std::vector<uint32_t> m_fitting{};
+
+    public:
+    BasicMultiSolver(const BasicSolverContext<N>& ctx, size_t n_boards);
+
+    const solver_type& solver(size_t board) const noexcept { return m_solvers[board]; }
+    // every board that isn't solved takes in the feedback of the previous guess first
+    guess_t next_guess(std::span<const MultiBoard<N>> boards);
+};
+
+// Game d plays the days d to d + n_boards - 1 (wrapping around the solutions) on its boards. Failed games are
+// reported by their first day.
+template <size_t N>
+bool solve_multi_game(const BasicSolverContext<N>& ctx, size_t n_boards, size_t day, GuessData& data,
+                      BoardOutput output, std::string& out);
+template <size_t N>
+GuessData solve_multi_loop(const BasicSolverContext<N>& ctx, size_t n_boards, size_t start, size_t end,
+                           BoardOutput output = BoardOutput::Full, ProgressSlot* progress = nullptr);
+template <size_t N>
+GuessData solve_multi_loop_parallel(const BasicSolverContext<N>& ctx, size_t n_boards, size_t start, size_t end,
+                                    ThreadPool& pool, SweepProgress* progress = nullptr);
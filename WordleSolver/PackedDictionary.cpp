@@ -0,0 +1,17 @@
+#include "PackedDictionary.h"
+
+template <size_t N>
+BasicPackedDictionary<N>::BasicPackedDictionary(std::span<const WordView> words) : m_size(words.size()) {
+    const size_t padded = (m_size + block_size - 1) / block_size * block_size;
+    for (auto& column : m_letters)
+        column.resize(padded);
+    m_masks.resize(padded);
+    for (size_t i = 0; i < m_size; i++) {
+        for (size_t pos = 0; pos < word_size; pos++)
+            m_letters[pos][i] = static_cast<uint8_t>(words[i].word[pos] - 'a');
+        m_masks[i] = from_enum(words[i].word_mask);
+    }
+}
+
+#define WS_INSTANTIATE_PACKED(N) template class BasicPackedDictionary<N>;
+WS_FOR_EACH_WORD_SIZE(WS_INSTANTIATE_PACKED)
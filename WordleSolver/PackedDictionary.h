@@ -0,0 +1,31 @@
+#pragma once
+#include "Pattern.h"
+#include "data/DictionaryLoader.h"
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Structure-of-arrays copy of a dictionary for the filter kernels: the letter (0-25) every word has at each position
+// and the WordMask of every word, in dictionary order. Columns are padded so kernels can always load whole blocks.
+// Every word has N letters.
+template <size_t N>
+class BasicPackedDictionary {
+    public:
+    static constexpr size_t word_size = N;
+    static constexpr size_t block_size = 32;
+
+    private:
+    std::array<std::vector<uint8_t>, word_size> m_letters;
+    std::vector<uint32_t> m_masks;
+    size_t m_size;
+
+    public:
+    explicit BasicPackedDictionary(std::span<const WordView> words);
+
+    size_t size() const noexcept { return m_size; }
+    const uint8_t* letters(size_t pos) const noexcept { return m_letters[pos].data(); }
+    const uint32_t* masks() const noexcept { return m_masks.data(); }
+};
+
+using PackedDictionary = BasicPackedDictionary<default_word_size>;
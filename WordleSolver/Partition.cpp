@@ -0,0 +1,71 @@
+#include "Partition.h"
+#include "PatternKernel.h"
+#include "PatternMatrix.h"
+
+namespace {
+    template <typename T>
+    void count_banked(const pattern_t* r, const candidate_t* cand, size_t n,
+                      std::array<uint32_t, pattern_count>& counts) noexcept {
+        alignas(64) T banks[4][pattern_count]{};
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            banks[0][r[cand[i]]]++;
+            banks[1][r[cand[i + 1]]]++;
+            banks[2][r[cand[i + 2]]]++;
+            banks[3][r[cand[i + 3]]]++;
+        }
+        for (; i < n; i++)
+            banks[0][r[cand[i]]]++;
+        for (size_t b = 0; b < pattern_count; b++)
+            counts[b] = uint32_t{banks[0][b]} + banks[1][b] + banks[2][b] + banks[3][b];
+    }
+}
+
+void count_feedback(std::span<const pattern_t> row, std::span<const candidate_t> candidates,
+                    std::array<uint32_t, pattern_count>& counts) noexcept {
+    // a bank counts a quarter of the candidates (the first one up to 3 more), 16 bits hold that unless the solution
+    // list is huge
+    const size_t n = candidates.size();
+    if (n / 4 + 3 <= UINT16_MAX) {
+        count_banked<uint16_t>(row.data(), candidates.data(), n, counts);
+    } else {
+        count_banked<uint32_t>(row.data(), candidates.data(), n, counts);
+    }
+}
+
+template <size_t N>
+void BasicPartition<N>::split(const PatternMatrix* patterns, std::span<const std::string_view> solutions,
+                              guess_t guess, std::span<const candidate_t> candidates) {
+    const auto& [word, special, word_idx] = guess;
+    m_sorted.resize(candidates.size());
+    m_offsets.fill(0);
+    if constexpr (N == PatternMatrix::word_size) {
+        if (patterns) {
+            // counted straight from the table, the row is read again to scatter instead of keeping the feedback
+            const PatternRow row = patterns->row(word_idx);
+            std::array<uint32_t, pattern_count> counts;
+            count_feedback(row, candidates, counts);
+            for (size_t p = 0; p < bucket_count; p++)
+                m_offsets[p + 1] = m_offsets[p] + counts[p];
+            auto next = m_offsets;
+            for (candidate_t c : candidates)
+                m_sorted[next[row[c]]++] = c;
+            return;
+        }
+    }
+    m_codes.resize(candidates.size());
+    for (size_t i = 0; i < candidates.size(); i++)
+        m_codes[i] = pack_word<N>(solutions[candidates[i]]);
+    m_feedback.resize(candidates.size());
+    compute_patterns<N>(pack_word<N>(word), m_codes, m_feedback.data());
+    for (pattern_type p : m_feedback)
+        m_offsets[p + 1]++;
+    for (size_t p = 1; p < m_offsets.size(); p++)
+        m_offsets[p] += m_offsets[p - 1];
+    auto next = m_offsets;
+    for (size_t i = 0; i < candidates.size(); i++)
+        m_sorted[next[m_feedback[i]]++] = candidates[i];
+}
+
+#define WS_INSTANTIATE_PARTITION(N) template class BasicPartition<N>;
+WS_FOR_EACH_WORD_SIZE(WS_INSTANTIATE_PARTITION)
@@ -0,0 +1,50 @@
+#pragma once
+#include "Board.h"
+#include "Pattern.h"
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+class PatternMatrix;
+
+// index of a solution in the solutions list, i.e. a column of the pattern matrix
+using candidate_t = uint32_t;
+
+// Bucket sizes of the feedback one guess gets against every candidate, from the guess's row of the pattern table.
+// The inner loop of the entropy scorer: the counting is spread over 4 interleaved banks so that consecutive
+// candidates never increment the same counter back to back, and it doesn't serialize on store-to-load forwarding when
+// many candidates share a bucket.
+void count_feedback(std::span<const pattern_t> row, std::span<const candidate_t> candidates,
+                    std::array<uint32_t, pattern_count>& counts) noexcept;
+
+// The candidates bucketed by the feedback one guess gets against each of them, a counting sort so every bucket keeps
+// the order of the candidates. Used by the strategy tree and the adversarial host. The buffers are kept between
+// splits, so reusing one object doesn't allocate once it has seen its largest candidate set.
+template <size_t N>
+class BasicPartition {
+    public:
+    using pattern_type = basic_pattern_t<N>;
+    static constexpr size_t bucket_count = basic_pattern_count<N>;
+
+    private:
+    std::vector<candidate_t> m_sorted{};
+    // bucket p is m_sorted[m_offsets[p], m_offsets[p + 1])
+    std::array<uint32_t, bucket_count + 1> m_offsets{};
+    // without the table: the candidates packed and their feedback
+    std::vector<basic_word_code_t<N>> m_codes{};
+    std::vector<pattern_type> m_feedback{};
+
+    public:
+    // the feedback is looked up in the pattern table if there is one, computed from the words otherwise
+    void split(const PatternMatrix* patterns, std::span<const std::string_view> solutions, guess_t guess,
+               std::span<const candidate_t> candidates);
+
+    size_t size(size_t pattern) const noexcept { return m_offsets[pattern + 1] - m_offsets[pattern]; }
+    std::span<const candidate_t> bucket(size_t pattern) const noexcept {
+        return std::span{m_sorted}.subspan(m_offsets[pattern], size(pattern));
+    }
+};
+
+using Partition = BasicPartition<default_word_size>;
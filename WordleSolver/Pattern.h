@@ -0,0 +1,124 @@
+#pragma once
+#include "Common.h"
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+enum class CharState { Wrong = 0, Misplaced = 1, Correct = 2 };
+
+// word lengths the game engine is compiled for, the built-in word lists have 5 letters
+constexpr size_t min_word_size = 4;
+constexpr size_t max_word_size = 8;
+constexpr size_t default_word_size = 5;
+
+// expands X(n) for every word length from min_word_size to max_word_size, for the explicit instantiations
+#define WS_FOR_EACH_WORD_SIZE(X) X(4) X(5) X(6) X(7) X(8)
+
+constexpr size_t pow3(size_t n) { return n == 0 ? 1 : 3 * pow3(n - 1); }
+
+// The feedback of a guess against a solution, one base-3 digit (a CharState) per letter.
+// The first letter is the least significant digit, so up to 5 letters fit in a single byte.
+template <size_t N>
+using basic_pattern_t = std::conditional_t<pow3(N) <= 256, uint8_t, uint16_t>;
+template <size_t N>
+constexpr size_t basic_pattern_count = pow3(N);
+
+using pattern_t = basic_pattern_t<default_word_size>;
+constexpr size_t pattern_count = basic_pattern_count<default_word_size>;
+constexpr pattern_t solved_pattern = pattern_count - 1;
+
+template <size_t SZ>
+constexpr basic_pattern_t<SZ> encode_pattern(const CharState (&states)[SZ]) {
+    basic_pattern_t<SZ> code = 0;
+    for (size_t i = SZ; i > 0; i--)
+        code = static_cast<basic_pattern_t<SZ>>(code * 3 + from_enum(states[i - 1]));
+    return code;
+}
+
+template <size_t SZ>
+constexpr void decode_pattern(basic_pattern_t<SZ> code, CharState (&states)[SZ]) {
+    for (size_t i = 0; i < SZ; i++) {
+        states[i] = to_enum<CharState>(code % 3);
+        code /= 3;
+    }
+}
+
+// Greens are assigned first, then yellows left to right while the solution still has unmatched copies of the letter.
+// Both words have N letters.
+template <size_t N = default_word_size>
+constexpr basic_pattern_t<N> compute_pattern(std::string_view guess, std::string_view solution) {
+    uint8_t marked[26]{};
+    CharState states[N]{};
+    for (char c : solution)
+        marked[c - 'a']++;
+
+    for (size_t i = 0; i < N; i++) {
+        if (guess[i] == solution[i]) {
+            states[i] = CharState::Correct;
+            marked[guess[i] - 'a']--;
+        }
+    }
+
+    for (size_t i = 0; i < N; i++) {
+        if (states[i] == CharState::Correct) continue;
+        uint8_t& times_found = marked[guess[i] - 'a'];
+        if (times_found > 0) {
+            states[i] = CharState::Misplaced;
+            times_found--;
+        }
+    }
+
+    return encode_pattern(states);
+}
+
+// A word packed into an integer, 5 bits per letter (0-25) with the first letter in the lowest bits: a 32-bit word
+// holds up to 6 letters, longer words take 64 bits.
+template <size_t N>
+using basic_word_code_t = std::conditional_t<5 * N <= 32, uint32_t, uint64_t>;
+
+template <size_t N>
+constexpr basic_word_code_t<N> pack_word(std::string_view word) {
+    basic_word_code_t<N> code = 0;
+    for (size_t i = 0; i < N; i++)
+        code |= static_cast<basic_word_code_t<N>>(word[i] - 'a') << (5 * i);
+    return code;
+}
+
+template <size_t N>
+constexpr size_t code_letter(basic_word_code_t<N> code, size_t pos) {
+    return static_cast<size_t>((code >> (5 * pos)) & 31);
+}
+
+// compute_pattern on packed words: the solution letters that aren't green are counted while the greens are found,
+// the yellows are then given out from the counts
+template <size_t N>
+constexpr basic_pattern_t<N> compute_packed_pattern(basic_word_code_t<N> guess, basic_word_code_t<N> solution) {
+    uint8_t unmatched[26]{};
+    CharState states[N]{};
+    for (size_t i = 0; i < N; i++) {
+        if (code_letter<N>(guess, i) == code_letter<N>(solution, i)) {
+            states[i] = CharState::Correct;
+        } else {
+            unmatched[code_letter<N>(solution, i)]++;
+        }
+    }
+    for (size_t i = 0; i < N; i++) {
+        if (states[i] == CharState::Correct) continue;
+        uint8_t& left = unmatched[code_letter<N>(guess, i)];
+        if (left > 0) {
+            states[i] = CharState::Misplaced;
+            left--;
+        }
+    }
+    return encode_pattern(states);
+}
+
+static_assert(compute_pattern("cigar", "cigar") == solved_pattern);
+static_assert(compute_pattern("speed", "abide") == 1 * 9 + 1 * 81);
+static_assert(compute_pattern<7>("letters", "settler") == 1 + 2 * 3 + 2 * 9 + 2 * 27 + 1 * 81 + 1 * 243 + 1 * 729);
+static_assert(compute_packed_pattern<5>(pack_word<5>("speed"), pack_word<5>("abide")) ==
+              compute_pattern("speed", "abide"));
+static_assert(compute_packed_pattern<5>(pack_word<5>("eerie"), pack_word<5>("hello")) ==
+              compute_pattern("eerie", "hello"));
+static_assert(compute_packed_pattern<7>(pack_word<7>("letters"), pack_word<7>("settler")) ==
+              compute_pattern<7>("letters", "settler"));
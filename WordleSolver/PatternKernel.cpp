@@ -0,0 +1,99 @@
+#include "PatternKernel.h"
+#include "Simd.h"
+#include <type_traits>
+
+namespace {
+#if WS_HAS_X86
+    // One 32-bit lane per solution. A letter of the guess that isn't green is yellow when the solution has more
+    // copies of it off the greens than the guess has copies of it off the greens before that position, which is the
+    // two passes of compute_pattern without the running counts.
+    template <size_t N>
+    WS_TARGET_AVX2 void compute_patterns_avx2(uint32_t guess, const uint32_t* solutions, size_t n,
+                                              basic_pattern_t<N>* out) {
+        const __m256i letter_mask = _mm256_set1_epi32(31);
+        const __m256i zero = _mm256_setzero_si256();
+        size_t guess_letters[N];
+        __m256i guess_letter[N];
+        __m256i green_digit[N];
+        __m256i yellow_digit[N];
+        for (size_t i = 0; i < N; i++) {
+            guess_letters[i] = code_letter<N>(guess, i);
+            guess_letter[i] = _mm256_set1_epi32(static_cast<int>(guess_letters[i]));
+            green_digit[i] = _mm256_set1_epi32(static_cast<int>(from_enum(CharState::Correct) * pow3(i)));
+            yellow_digit[i] = _mm256_set1_epi32(static_cast<int>(from_enum(CharState::Misplaced) * pow3(i)));
+        }
+
+        size_t s = 0;
+        for (; s + 8 <= n; s += 8) {
+            __m256i codes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(solutions + s));
+            __m256i letters[N];
+            __m256i green[N];
+            for (size_t k = 0; k < N; k++) {
+                letters[k] = _mm256_and_si256(codes, letter_mask);
+                green[k] = _mm256_cmpeq_epi32(letters[k], guess_letter[k]);
+                codes = _mm256_srli_epi32(codes, 5);
+            }
+            __m256i pattern = zero;
+            for (size_t i = 0; i < N; i++) {
+                // the compares are -1 per hit, so subtracting them counts
+                __m256i unmatched = zero;
+                for (size_t k = 0; k < N; k++) {
+                    __m256i copy = _mm256_cmpeq_epi32(letters[k], guess_letter[i]);
+                    unmatched = _mm256_sub_epi32(unmatched, _mm256_andnot_si256(green[k], copy));
+                }
+                __m256i taken = zero;
+                for (size_t j = 0; j < i; j++) {
+                    if (guess_letters[j] == guess_letters[i])
+                        taken = _mm256_sub_epi32(taken, _mm256_cmpeq_epi32(green[j], zero));
+                }
+                __m256i yellow = _mm256_andnot_si256(green[i], _mm256_cmpgt_epi32(unmatched, taken));
+                pattern = _mm256_add_epi32(pattern, _mm256_or_si256(_mm256_and_si256(green[i], green_digit[i]),
+                                                                    _mm256_and_si256(yellow, yellow_digit[i])));
+            }
+
+            // narrowed to the pattern type: the low bytes of every lane to the bottom of each 128-bit half, then the
+            // two halves next to each other
+            if constexpr (sizeof(basic_pattern_t<N>) == 1) {
+                const __m256i bytes = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                       0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+                __m256i packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(pattern, bytes),
+                                                             _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out + s), _mm256_castsi256_si128(packed));
+            } else {
+                const __m256i words = _mm256_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                       0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+                __m256i packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(pattern, words),
+                                                             _mm256_setr_epi32(0, 1, 4, 5, 0, 0, 0, 0));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + s), _mm256_castsi256_si128(packed));
+            }
+        }
+        for (; s < n; s++)
+            out[s] = compute_packed_pattern<N>(guess, solutions[s]);
+    }
+#endif
+}
+
+template <size_t N>
+void compute_patterns_scalar(basic_word_code_t<N> guess, std::span<const basic_word_code_t<N>> solutions,
+                             basic_pattern_t<N>* out) noexcept {
+    for (size_t s = 0; s < solutions.size(); s++)
+        out[s] = compute_packed_pattern<N>(guess, solutions[s]);
+}
+
+template <size_t N>
+void compute_patterns(basic_word_code_t<N> guess, std::span<const basic_word_code_t<N>> solutions,
+                      basic_pattern_t<N>* out) noexcept {
+#if WS_HAS_X86
+    if constexpr (std::is_same_v<basic_word_code_t<N>, uint32_t>) {
+        if (cpu_has_avx2()) return compute_patterns_avx2<N>(guess, solutions.data(), solutions.size(), out);
+    }
+#endif
+    compute_patterns_scalar<N>(guess, solutions, out);
+}
+
+#define WS_INSTANTIATE_PATTERN_KERNEL(N)                                                                              \
+    template void compute_patterns<N>(basic_word_code_t<N>, std::span<const basic_word_code_t<N>>,                   \
+                                      basic_pattern_t<N>*) noexcept;                                                  \
+    template void compute_patterns_scalar<N>(basic_word_code_t<N>, std::span<const basic_word_code_t<N>>,            \
+                                             basic_pattern_t<N>*) noexcept;
+WS_FOR_EACH_WORD_SIZE(WS_INSTANTIATE_PATTERN_KERNEL)
@@ -0,0 +1,14 @@
+#pragma once
+#include "Pattern.h"
+#include <span>
+
+// The feedback of one guess against a block of packed solutions, out[i] for solutions[i], by the same rules as
+// compute_pattern (greens first, then yellows left to right while the solution has unmatched copies of the letter).
+// Used by the pattern table build and by partitions computed without the table. Uses AVX2 (8 solutions per block)
+// when the CPU supports it and the words fit in 32 bits.
+template <size_t N>
+void compute_patterns(basic_word_code_t<N> guess, std::span<const basic_word_code_t<N>> solutions,
+                      basic_pattern_t<N>* out) noexcept;
+template <size_t N>
+void compute_patterns_scalar(basic_word_code_t<N> guess, std::span<const basic_word_code_t<N>> solutions,
+                             basic_pattern_t<N>* out) noexcept;
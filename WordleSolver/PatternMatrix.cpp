@@ -0,0 +1,274 @@
+#include "PatternMatrix.h"
+#include "PatternKernel.h"
+#include <algorithm>
+#include <cstring>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+    constexpr char cache_magic[8]{'W', 'S', 'P', 'A', 'T', 'M', 'X', '\0'};
+    constexpr uint32_t cache_version = 1;
+
+    struct CacheHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t header_size;
+        uint64_t rows;
+        uint64_t cols;
+        uint64_t hash;
+    };
+
+    using word_code_t = basic_word_code_t<PatternMatrix::word_size>;
+
+    void fill_rows(pattern_t* out, std::span<const WordView> words, std::span<const word_code_t> solutions,
+                   size_t start, size_t end) {
+        for (size_t i = start; i < end; i++) {
+            pattern_t* row = out + i * solutions.size();
+            compute_patterns<PatternMatrix::word_size>(pack_word<PatternMatrix::word_size>(words[i].word), solutions,
+                                                       row);
+        }
+    }
+}
+
+PatternMatrix::PatternMatrix(std::span<const WordView> words, std::span<const std::string_view> solutions) :
+    m_owned(words.size() * solutions.size()), m_rows(words.size()), m_cols(solutions.size()) {
+    m_data = m_owned.data();
+    // every solution is compared with every word, packed once here
+    std::vector<word_code_t> packed_solutions(solutions.size());
+    std::ranges::transform(solutions, packed_solutions.begin(), pack_word<word_size>);
+    size_t n_threads = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, std::max<size_t>(m_rows, 1));
+    size_t per_thread = (m_rows + n_threads - 1) / n_threads;
+    std::vector<std::jthread> threads{};
+    threads.reserve(n_threads);
+    const std::span<const word_code_t> sols{packed_solutions};
+    for (size_t start = 0; start < m_rows; start += per_thread)
+        threads.emplace_back(fill_rows, m_owned.data(), words, sols, start, std::min(m_rows, start + per_thread));
+}
+
+PatternMatrix::PatternMatrix(MappedFile&& file, size_t rows, size_t cols) :
+    m_file(std::move(file)), m_rows(rows), m_cols(cols) {
+    m_data = reinterpret_cast<const pattern_t*>(m_file.bytes().data() + sizeof(CacheHeader));
+}
+
+// LRU of the blocks of rows of a tiled table, shared by all threads. Blocks are computed outside the lock, two threads
+// missing the same block both compute it and the second one takes the block of the first.
+class PatternMatrix::TileCache {
+    using block_ptr = std::shared_ptr<const std::vector<pattern_t>>;
+
+    struct Entry {
+        block_ptr block;
+        std::list<size_t>::iterator lru;
+    };
+
+    std::mutex m_mutex{};
+    std::unordered_map<size_t, Entry> m_blocks{};
+    // block indices, most recently used first
+    std::list<size_t> m_lru{};
+    size_t m_capacity;
+    std::atomic<size_t> m_hits{0};
+    std::atomic<size_t> m_misses{0};
+    std::atomic<size_t> m_evictions{0};
+
+    public:
+    explicit TileCache(size_t capacity) : m_capacity(capacity) { m_blocks.reserve(capacity); }
+
+    size_t capacity() const noexcept { return m_capacity; }
+    void count_miss() noexcept { m_misses.fetch_add(1, std::memory_order_relaxed); }
+
+    // the block if it's held, null (and a miss) otherwise
+    block_ptr find(size_t tile) {
+        {
+            std::lock_guard lock{m_mutex};
+            if (auto it = m_blocks.find(tile); it != m_blocks.end()) {
+                m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+                m_hits.fetch_add(1, std::memory_order_relaxed);
+                return it->second.block;
+            }
+        }
+        count_miss();
+        return nullptr;
+    }
+
+    // holds a computed block, evicting the least recently used one if the cache is full. Returns the block held
+    block_ptr insert(size_t tile, block_ptr block) {
+        std::lock_guard lock{m_mutex};
+        if (auto it = m_blocks.find(tile); it != m_blocks.end()) {
+            m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+            return it->second.block;
+        }
+        if (m_blocks.size() == m_capacity) {
+            m_blocks.erase(m_lru.back());
+            m_lru.pop_back();
+            m_evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_lru.push_front(tile);
+        m_blocks.emplace(tile, Entry{block, m_lru.begin()});
+        return block;
+    }
+
+    TileStats stats() {
+        std::lock_guard lock{m_mutex};
+        return {m_hits.load(std::memory_order_relaxed), m_misses.load(std::memory_order_relaxed),
+                m_evictions.load(std::memory_order_relaxed), m_blocks.size(), m_capacity};
+    }
+};
+
+PatternMatrix::PatternMatrix(std::span<const WordView> words, std::span<const std::string_view> solutions,
+                             size_t tile_capacity) :
+    m_rows(words.size()), m_cols(solutions.size()), m_word_codes(words.size()), m_solution_codes(solutions.size()),
+    m_tiles(std::make_unique<TileCache>(tile_capacity)) {
+    std::ranges::transform(words, m_word_codes.begin(), [](const WordView& w) { return pack_word<word_size>(w.word); });
+    std::ranges::transform(solutions, m_solution_codes.begin(), pack_word<word_size>);
+}
+
+PatternMatrix::PatternMatrix(PatternMatrix&&) noexcept = default;
+PatternMatrix& PatternMatrix::operator=(PatternMatrix&&) noexcept = default;
+PatternMatrix::~PatternMatrix() = default;
+
+PatternStorage PatternMatrix::storage() const noexcept {
+    if (!m_tiles) return PatternStorage::Full;
+    return m_tiles->capacity() > 0 ? PatternStorage::Tiled : PatternStorage::OnTheFly;
+}
+
+pattern_t PatternMatrix::compute_at(size_t word_idx, size_t solution_idx) const {
+    if (m_tiles->capacity() > 0) return row(word_idx)[solution_idx];
+    m_tiles->count_miss();
+    return compute_packed_pattern<word_size>(m_word_codes[word_idx], m_solution_codes[solution_idx]);
+}
+
+PatternRow PatternMatrix::compute_row(size_t word_idx) const {
+    if (m_tiles->capacity() == 0) {
+        m_tiles->count_miss();
+        auto block = std::make_shared<std::vector<pattern_t>>(m_cols);
+        compute_patterns<word_size>(m_word_codes[word_idx], m_solution_codes, block->data());
+        const std::span<const pattern_t> row{*block};
+        return PatternRow{row, std::move(block)};
+    }
+    const size_t tile = word_idx / tile_rows;
+    auto block = m_tiles->find(tile);
+    if (!block) {
+        const size_t first = tile * tile_rows;
+        const size_t n = std::min(tile_rows, m_rows - first);
+        auto computed = std::make_shared<std::vector<pattern_t>>(n * m_cols);
+        for (size_t r = 0; r < n; r++)
+            compute_patterns<word_size>(m_word_codes[first + r], m_solution_codes, computed->data() + r * m_cols);
+        block = m_tiles->insert(tile, std::move(computed));
+    }
+    const auto row = std::span<const pattern_t>{*block}.subspan(word_idx % tile_rows * m_cols, m_cols);
+    return PatternRow{row, std::move(block)};
+}
+
+PatternMatrix::TileStats PatternMatrix::tile_stats() const {
+    return m_tiles ? m_tiles->stats() : TileStats{};
+}
+
+void PatternMatrix::print_stats(std::ostream& out) const {
+    if (!m_tiles) return;
+    const TileStats stats = tile_stats();
+    if (stats.capacity > 0) {
+        out << "Pattern tiles: " << stats.hits << " hits, " << stats.misses << " misses, " << stats.evictions
+            << " evictions, " << stats.resident << " of " << stats.capacity << " blocks held\n";
+    } else {
+        out << "Patterns computed on the fly: " << stats.misses << " rows and single patterns\n";
+    }
+}
+
+std::vector<uint32_t> PatternMatrix::solution_rows(std::span<const WordView> words,
+                                                   std::span<const std::string_view> solutions) {
+    std::unordered_map<std::string_view, uint32_t> rows{};
+    rows.reserve(words.size());
+    for (size_t i = 0; i < words.size(); i++)
+        rows.emplace(words[i].word, static_cast<uint32_t>(i));
+    std::vector<uint32_t> result{};
+    result.reserve(solutions.size());
+    for (auto sol : solutions) {
+        auto it = rows.find(sol);
+        if (it == rows.end()) throw std::runtime_error("Solution " + std::string{sol} + " is not in the dictionary");
+        result.push_back(it->second);
+    }
+    return result;
+}
+
+uint64_t PatternMatrix::dictionary_hash(std::span<const WordView> words, std::span<const std::string_view> solutions) {
+    // FNV-1a, a separator after every word so that different splits of the same letters hash differently
+    uint64_t hash = 14695981039346656037ull;
+    auto feed = [&hash](std::string_view str) {
+        for (char c : str) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+        hash ^= '\n';
+        hash *= 1099511628211ull;
+    };
+    for (const auto& word : words)
+        feed(word.word);
+    feed("");
+    for (const auto& sol : solutions)
+        feed(sol);
+    return hash;
+}
+
+PatternMatrix PatternMatrix::load_or_build(std::span<const WordView> words,
+                                           std::span<const std::string_view> solutions,
+                                           const std::filesystem::path& cache, size_t memory_budget) {
+    const size_t data_size = words.size() * solutions.size();
+    if (data_size > memory_budget) {
+        const size_t capacity = memory_budget / (tile_rows * std::max<size_t>(solutions.size(), 1));
+        return PatternMatrix{words, solutions, capacity >= min_tiles ? capacity : 0};
+    }
+    const uint64_t hash = dictionary_hash(words, solutions);
+    auto header_matches = [&](std::span<const std::byte> bytes) {
+        if (bytes.size() != sizeof(CacheHeader) + data_size) return false;
+        CacheHeader header{};
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        return std::memcmp(header.magic, cache_magic, sizeof(cache_magic)) == 0 && header.version == cache_version &&
+               header.header_size == sizeof(CacheHeader) && header.rows == words.size() &&
+               header.cols == solutions.size() && header.hash == hash;
+    };
+
+    std::error_code ec{};
+    if (std::filesystem::exists(cache, ec)) {
+        try {
+            MappedFile file{cache};
+            if (header_matches(file.bytes())) return PatternMatrix{std::move(file), words.size(), solutions.size()};
+        } catch (const std::runtime_error&) {
+            // unreadable cache, treated as stale
+        }
+    }
+
+    PatternMatrix matrix = build(words, solutions);
+    CacheHeader header{};
+    std::memcpy(header.magic, cache_magic, sizeof(cache_magic));
+    header.version = cache_version;
+    header.header_size = sizeof(CacheHeader);
+    header.rows = words.size();
+    header.cols = solutions.size();
+    header.hash = hash;
+
+    // write to a temporary of this run first so that a concurrent run never maps a half-written cache
+    const auto tmp = unique_temp_path(cache);
+    {
+        std::ofstream out{tmp, std::ios::binary | std::ios::trunc};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(matrix.m_owned.data()), static_cast<std::streamsize>(data_size));
+        if (!out) {
+            std::cerr << "Couldn't write the pattern cache " << cache << ", continuing without it\n";
+            out.close();
+            std::filesystem::remove(tmp, ec);
+            return matrix;
+        }
+    }
+    std::filesystem::rename(tmp, cache, ec);
+    if (ec) {
+        std::cerr << "Couldn't write the pattern cache " << cache << ", continuing without it\n";
+        std::filesystem::remove(tmp, ec);
+    }
+    return matrix;
+}
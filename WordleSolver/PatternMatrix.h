@@ -0,0 +1,122 @@
+#pragma once
+#include "MappedFile.h"
+#include "Pattern.h"
+#include "data/DictionaryLoader.h"
+#include <filesystem>
+#include <iosfwd>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// room for the built-in table many times over, bigger tables are tiled
+constexpr size_t default_pattern_budget = size_t{1} << 30;
+
+// how the table is held, picked by load_or_build from its size and the memory budget
+enum class PatternStorage {
+    // the whole table, mapped from the cache or built
+    Full,
+    // blocks of rows computed when first asked for, the least recently used ones dropped to stay in the budget
+    Tiled,
+    // every row computed whenever it's asked for, when the budget doesn't even hold a few blocks
+    OnTheFly,
+};
+
+// A row of the table. A row of a table that isn't held whole owns a reference to its block, so it stays valid after
+// the block was evicted.
+class PatternRow {
+    std::shared_ptr<const std::vector<pattern_t>> m_block{};
+    std::span<const pattern_t> m_row{};
+
+    public:
+    explicit PatternRow(std::span<const pattern_t> row,
+                        std::shared_ptr<const std::vector<pattern_t>> block = nullptr) noexcept :
+        m_block(std::move(block)), m_row(row) {}
+
+    const pattern_t* data() const noexcept { return m_row.data(); }
+    size_t size() const noexcept { return m_row.size(); }
+    pattern_t operator[](size_t solution_idx) const noexcept { return m_row[solution_idx]; }
+    operator std::span<const pattern_t>() const noexcept { return m_row; }
+};
+
+// Feedback of every dictionary word against every solution, one byte per pair, row-major by dictionary word.
+// Rows follow the order of the dictionary it was built from, columns the order of the solutions.
+class PatternMatrix {
+    public:
+    // a pattern_t is the feedback of a word of this length
+    static constexpr size_t word_size = default_word_size;
+    // rows per block of a tiled table
+    static constexpr size_t tile_rows = 64;
+    // a tiled table holds at least this many blocks, with less room the rows are computed on the fly
+    static constexpr size_t min_tiles = 4;
+
+    struct TileStats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+        size_t resident = 0;
+        size_t capacity = 0;
+    };
+
+    private:
+    using word_code_t = basic_word_code_t<word_size>;
+    class TileCache;
+
+    MappedFile m_file;
+    std::vector<pattern_t> m_owned;
+    // null unless the whole table is held
+    const pattern_t* m_data = nullptr;
+    size_t m_rows = 0;
+    size_t m_cols = 0;
+    // the packed lists the rows of a table that isn't held whole are computed from
+    std::vector<word_code_t> m_word_codes{};
+    std::vector<word_code_t> m_solution_codes{};
+    // null when the whole table is held, holds no block when it's computed on the fly
+    std::unique_ptr<TileCache> m_tiles{};
+
+    PatternMatrix(std::span<const WordView> words, std::span<const std::string_view> solutions);
+    PatternMatrix(MappedFile&& file, size_t rows, size_t cols);
+    // a table that isn't held whole, tiled in up to tile_capacity blocks or computed on the fly if that's 0
+    PatternMatrix(std::span<const WordView> words, std::span<const std::string_view> solutions, size_t tile_capacity);
+
+    pattern_t compute_at(size_t word_idx, size_t solution_idx) const;
+    PatternRow compute_row(size_t word_idx) const;
+
+    public:
+    // the dictionary index of every solution, throws if one isn't in the dictionary
+    static std::vector<uint32_t> solution_rows(std::span<const WordView> words,
+                                               std::span<const std::string_view> solutions);
+    static uint64_t dictionary_hash(std::span<const WordView> words, std::span<const std::string_view> solutions);
+
+    // Holds the whole table if it fits the memory budget: maps the cache file if it matches the given lists,
+    // otherwise builds the table and (tries to) write the cache. A bigger table is tiled in the budget, or computed
+    // on the fly if the budget holds less than min_tiles blocks, and never cached.
+    static PatternMatrix load_or_build(std::span<const WordView> words, std::span<const std::string_view> solutions,
+                                       const std::filesystem::path& cache,
+                                       size_t memory_budget = default_pattern_budget);
+    static PatternMatrix build(std::span<const WordView> words, std::span<const std::string_view> solutions) {
+        return PatternMatrix{words, solutions};
+    }
+
+    PatternMatrix(PatternMatrix&&) noexcept;
+    PatternMatrix& operator=(PatternMatrix&&) noexcept;
+    ~PatternMatrix();
+
+    size_t rows() const noexcept { return m_rows; }
+    size_t cols() const noexcept { return m_cols; }
+    bool mapped() const noexcept { return m_file.is_open(); }
+    PatternStorage storage() const noexcept;
+    pattern_t at(size_t word_idx, size_t solution_idx) const {
+        if (m_data) return m_data[word_idx * m_cols + solution_idx];
+        return compute_at(word_idx, solution_idx);
+    }
+    PatternRow row(size_t word_idx) const {
+        if (m_data) return PatternRow{{m_data + word_idx * m_cols, m_cols}};
+        return compute_row(word_idx);
+    }
+
+    // the counters of a table that isn't held whole, on the fly every row and pattern asked for is a miss
+    TileStats tile_stats() const;
+    // prints the counters, nothing for a table held whole
+    void print_stats(std::ostream& out) const;
+};
@@ -0,0 +1,61 @@
+#include "Progress.h"
+#include <algorithm>
+#include <condition_variable>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+namespace {
+    std::string format_duration(double seconds) {
+        std::ostringstream out{};
+        out << std::setfill('0');
+        if (seconds < 60.0) {
+            out << std::fixed << std::setprecision(1) << seconds << 's';
+            return out.str();
+        }
+        const auto total = static_cast<long long>(seconds);
+        if (total >= 3600) out << total / 3600 << 'h' << std::setw(2);
+        out << total / 60 % 60 << 'm' << std::setw(2) << total % 60 << 's';
+        return out.str();
+    }
+}
+
+SweepProgress::SweepProgress(size_t n_workers, size_t total_games) :
+    m_slots(std::make_unique<ProgressSlot[]>(n_workers)), m_n_slots(n_workers), m_total(total_games),
+    m_start(std::chrono::steady_clock::now()) {}
+
+SweepProgress::Sample SweepProgress::sample() const noexcept {
+    Sample sample{0, 0, m_total, std::chrono::steady_clock::now() - m_start};
+    for (size_t i = 0; i < m_n_slots; i++) {
+        sample.games += m_slots[i].games.load(std::memory_order_relaxed);
+        sample.solved += m_slots[i].solved.load(std::memory_order_relaxed);
+    }
+    return sample;
+}
+
+ProgressReporter::ProgressReporter(const SweepProgress& progress, std::chrono::milliseconds interval,
+                                   std::ostream& out) :
+    m_thread([&progress, interval, &out](std::stop_token stop) {
+        // only there to sleep on, nothing else waits on it: the stop token is what wakes it early
+        std::mutex mutex{};
+        std::condition_variable_any wake{};
+        std::unique_lock lock{mutex};
+        while (!wake.wait_for(lock, stop, interval, [&stop] { return stop.stop_requested(); })) {
+            const SweepProgress::Sample s = progress.sample();
+            const double seconds = std::chrono::duration<double>(s.elapsed).count();
+            const double rate = static_cast<double>(s.games) / seconds;
+            const auto percent = [](size_t part, size_t whole) {
+                return whole == 0 ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(whole);
+            };
+            std::string eta = "unknown";
+            if (s.games > 0) eta = format_duration(static_cast<double>(s.total - std::min(s.games, s.total)) / rate);
+            std::ostringstream line{};
+            line << std::fixed << std::setprecision(1) << "Progress: " << s.games << '/' << s.total << " games ("
+                 << percent(s.games, s.total) << "%), " << rate << " games/s, " << std::setprecision(2)
+                 << percent(s.solved, s.games) << "% solved, ETA " << eta << '\n';
+            // one write per line, so that it isn't interleaved with other output
+            out << line.str() << std::flush;
+        }
+    }) {}
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <thread>
+
+// Games one worker of a sweep has finished, on a cache line of its own. Only that worker writes it, so publishing is
+// a relaxed load and store rather than a read-modify-write, and the reporter reads it with relaxed loads.
+struct alignas(64) ProgressSlot {
+    std::atomic<size_t> games{0};
+    std::atomic<size_t> solved{0};
+
+    void add(size_t n_games, bool won) noexcept {
+        games.store(games.load(std::memory_order_relaxed) + n_games, std::memory_order_relaxed);
+        if (won) solved.store(solved.load(std::memory_order_relaxed) + n_games, std::memory_order_relaxed);
+    }
+};
+
+// The progress of a sweep of total games, one slot per worker.
+class SweepProgress {
+    std::unique_ptr<ProgressSlot[]> m_slots;
+    size_t m_n_slots;
+    size_t m_total;
+    std::chrono::steady_clock::time_point m_start;
+
+    public:
+    struct Sample {
+        size_t games;
+        size_t solved;
+        size_t total;
+        std::chrono::nanoseconds elapsed;
+    };
+
+    SweepProgress(size_t n_workers, size_t total_games);
+
+    ProgressSlot& slot(size_t worker) noexcept { return m_slots[worker]; }
+    // the slots summed, each one is current but they aren't read at the same instant
+    Sample sample() const noexcept;
+};
+
+// Prints a line with the games done, games/s, success rate and ETA of a sweep every interval, from its own thread.
+// Stopping it (or destroying it) wakes the thread right away instead of waiting out the interval.
+class ProgressReporter {
+    std::jthread m_thread;
+
+    public:
+    ProgressReporter(const SweepProgress& progress, std::chrono::milliseconds interval, std::ostream& out);
+
+    void stop() noexcept { m_thread.request_stop(); }
+};
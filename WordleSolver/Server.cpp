@@ -0,0 +1,496 @@
+#include "Server.h"
+#include <stdexcept>
+#ifdef __linux__
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std::string_view_literals;
+
+#ifdef __linux__
+namespace {
+    constexpr size_t max_request_line = 256;
+    constexpr int max_events = 256;
+    constexpr size_t read_chunk = 4096;
+    // replies a session holds for a client that doesn't read them, it isn't read from or served past this
+    constexpr size_t max_pending_output = 64 * 1024;
+    // requests a session holds before they're handled, it isn't read from past this
+    constexpr size_t max_pending_input = 64 * 1024;
+
+    [[noreturn]] void throw_errno(std::string_view what) {
+        throw std::runtime_error(std::string{what} + ": " + std::strerror(errno));
+    }
+
+    class FileDescriptor {
+        int m_fd = -1;
+
+        public:
+        explicit FileDescriptor(int fd = -1) noexcept : m_fd(fd) {}
+        FileDescriptor(FileDescriptor&& other) noexcept : m_fd(std::exchange(other.m_fd, -1)) {}
+        FileDescriptor& operator=(FileDescriptor&& other) noexcept {
+            std::swap(m_fd, other.m_fd);
+            return *this;
+        }
+        ~FileDescriptor() {
+            if (m_fd >= 0) ::close(m_fd);
+        }
+        int get() const noexcept { return m_fd; }
+    };
+
+    sockaddr_un socket_address(std::string_view path) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) throw std::runtime_error("Invalid socket path");
+        std::memcpy(addr.sun_path, path.data(), path.size());
+        return addr;
+    }
+
+    // what's at the path, nullopt if there's nothing
+    std::optional<struct stat> file_status(const char* path) noexcept {
+        struct stat st{};
+        if (::lstat(path, &st) != 0) return std::nullopt;
+        return st;
+    }
+
+    // false only if nothing accepts connections on the socket, a daemon that's gone left it behind
+    bool socket_in_use(const sockaddr_un& addr) {
+        FileDescriptor probe{::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+        if (probe.get() < 0) throw_errno("socket");
+        if (::connect(probe.get(), reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0) return true;
+        return errno != ECONNREFUSED;
+    }
+
+    std::string_view next_token(std::string_view& line) {
+        const size_t begin = std::min(line.find_first_not_of(" \t\r"sv), line.size());
+        const size_t end = std::min(line.find_first_of(" \t\r"sv, begin), line.size());
+        std::string_view token = line.substr(begin, end - begin);
+        line.remove_prefix(end);
+        return token;
+    }
+
+    std::optional<Strategy> parse_strategy(std::string_view name, Strategy default_strategy) {
+        if (name.empty()) return default_strategy;
+        if (name == "heuristic"sv) return Strategy::Heuristic;
+        if (name == "entropy"sv) return Strategy::Entropy;
+        return std::nullopt;
+    }
+
+    // a game in progress: the feedback so far and the guess waiting for feedback
+    struct Game {
+        Board board{};
+        Solver solver;
+        guess_t last;
+
+        explicit Game(const SolverContext& ctx) : solver(ctx), last(solver.next_guess(board)) {}
+    };
+
+    struct Session {
+        FileDescriptor fd;
+        // received, not handled yet
+        std::string in{};
+        // the line handled this round and the replies not sent yet
+        std::string request{};
+        std::string out{};
+        std::optional<Game> game{};
+        bool closing = false;
+        // what the descriptor is watched for
+        uint32_t events = EPOLLIN;
+
+        bool has_request() const noexcept { return in.find('\n') != std::string::npos; }
+    };
+
+    using contexts_t = std::array<const SolverContext*, 2>;
+
+    void reply_guess(Session& session) {
+        session.out += "guess ";
+        session.out += std::get<std::string_view>(session.game->last);
+        session.out += '\n';
+    }
+
+    // runs on a worker, only touches its own session
+    void handle(Session& session, const contexts_t& contexts, Strategy default_strategy) {
+        std::string_view line = session.request;
+        const std::string_view command = next_token(line);
+        const std::string_view argument = next_token(line);
+        if (!next_token(line).empty()) {
+            session.out += "error bad request\n";
+        } else if (command == "new"sv) {
+            auto strategy = parse_strategy(argument, default_strategy);
+            if (!strategy.has_value()) {
+                session.out += "error unknown strategy\n";
+                return;
+            }
+            session.game.emplace(*contexts[static_cast<size_t>(*strategy)]);
+            reply_guess(session);
+        } else if (command == "feedback"sv) {
+            if (!session.game.has_value()) {
+                session.out += "error no game, send new first\n";
+                return;
+            }
+            CharState states[PackedDictionary::word_size]{};
+            if (argument.size() != std::size(states) || argument.find_first_not_of("012"sv) != std::string_view::npos) {
+                session.out += "error bad feedback\n";
+                return;
+            }
+            for (size_t i = 0; i < argument.size(); i++)
+                states[i] = static_cast<CharState>(argument[i] - '0');
+            auto& game = *session.game;
+            game.board.apply(game.last, encode_pattern(states));
+            if (game.board.solved()) {
+                session.out += "solved " + std::to_string(game.board.guesses()) + '\n';
+                session.game.reset();
+            } else if (game.board.guesses() == game.board.max_guesses()) {
+                session.out += "lost\n";
+                session.game.reset();
+            } else {
+                game.last = game.solver.next_guess(game.board);
+                reply_guess(session);
+            }
+        } else if (command == "quit"sv && argument.empty()) {
+            session.out += "bye\n";
+            session.closing = true;
+        } else {
+            session.out += "error bad request\n";
+        }
+    }
+
+    class Server {
+        FileDescriptor m_epoll;
+        std::unordered_map<int, std::unique_ptr<Session>> m_sessions{};
+
+        void watch(int fd, uint32_t events, int op) {
+            epoll_event event{};
+            event.events = events;
+            event.data.fd = fd;
+            if (epoll_ctl(m_epoll.get(), op, fd, &event) != 0) throw_errno("epoll_ctl");
+        }
+
+        public:
+        Server() : m_epoll(epoll_create1(EPOLL_CLOEXEC)) {
+            if (m_epoll.get() < 0) throw_errno("epoll_create1");
+        }
+
+        int epoll() const noexcept { return m_epoll.get(); }
+        void add(int fd) { watch(fd, EPOLLIN, EPOLL_CTL_ADD); }
+
+        Session* session(int fd) {
+            auto it = m_sessions.find(fd);
+            return it == m_sessions.end() ? nullptr : it->second.get();
+        }
+
+        void accept_all(int listener) {
+            while (true) {
+                int fd = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+                    if (errno == EINTR || errno == ECONNABORTED) continue;
+                    throw_errno("accept4");
+                }
+                auto session = std::make_unique<Session>();
+                session->fd = FileDescriptor{fd};
+                add(fd);
+                m_sessions.emplace(fd, std::move(session));
+            }
+        }
+
+        // closing the descriptor takes it out of the epoll set
+        void drop(int fd) { m_sessions.erase(fd); }
+
+        // Only asks for writability while there's something left to write. A client that doesn't read its replies,
+        // or sends requests faster than they're handled, isn't read from until they drain.
+        void update_events(Session& session) {
+            const bool reading = session.out.size() < max_pending_output && session.in.size() < max_pending_input;
+            const uint32_t events = (reading ? static_cast<uint32_t>(EPOLLIN) : uint32_t{0}) |
+                                    (session.out.empty() ? uint32_t{0} : static_cast<uint32_t>(EPOLLOUT));
+            if (events != session.events) {
+                session.events = events;
+                watch(session.fd.get(), events, EPOLL_CTL_MOD);
+            }
+        }
+
+        // false if the peer is gone
+        bool receive(Session& session) {
+            char buffer[read_chunk];
+            while (session.in.size() < max_pending_input) {
+                ssize_t n = ::recv(session.fd.get(), buffer, sizeof(buffer), 0);
+                if (n > 0) {
+                    session.in.append(buffer, static_cast<size_t>(n));
+                    continue;
+                }
+                if (n == 0) return false;
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+                break;
+            }
+            update_events(session);
+            return true;
+        }
+
+        // false if the peer is gone
+        bool flush(Session& session) {
+            size_t sent = 0;
+            while (sent < session.out.size()) {
+                ssize_t n = ::send(session.fd.get(), session.out.data() + sent, session.out.size() - sent, MSG_NOSIGNAL);
+                if (n >= 0) {
+                    sent += static_cast<size_t>(n);
+                } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                } else if (errno != EINTR) {
+                    return false;
+                }
+            }
+            session.out.erase(0, sent);
+            update_events(session);
+            return true;
+        }
+    };
+}
+
+void run_server(std::string_view socket_path, size_t n_threads, Strategy default_strategy,
+                const std::function<const SolverContext&(Strategy)>& context) {
+    // the stop signals are read from a signalfd, so they have to be blocked in every thread, the pool's included
+    sigset_t signals{};
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    if (pthread_sigmask(SIG_BLOCK, &signals, nullptr) != 0) throw std::runtime_error("Failed to block the signals");
+    FileDescriptor signal_fd{signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC)};
+    if (signal_fd.get() < 0) throw_errno("signalfd");
+
+    contexts_t contexts{};
+    contexts[static_cast<size_t>(default_strategy)] = &context(default_strategy);
+    ThreadPool pool{n_threads};
+
+    const sockaddr_un addr = socket_address(socket_path);
+    FileDescriptor listener{::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)};
+    if (listener.get() < 0) throw_errno("socket");
+    // a socket left behind by a previous run would make bind fail, anything else at the path is left alone
+    if (const auto existing = file_status(addr.sun_path)) {
+        if (!S_ISSOCK(existing->st_mode))
+            throw std::runtime_error(std::string{socket_path} + " exists and isn't a socket");
+        if (socket_in_use(addr)) throw std::runtime_error(std::string{socket_path} + " is already in use");
+        ::unlink(addr.sun_path);
+    }
+    if (::bind(listener.get(), reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) throw_errno("bind");
+    // the socket this daemon removes on exit, unless another one took the path meanwhile
+    const auto bound = file_status(addr.sun_path);
+    if (::listen(listener.get(), SOMAXCONN) != 0) throw_errno("listen");
+
+    Server server{};
+    server.add(listener.get());
+    server.add(signal_fd.get());
+    std::array<epoll_event, max_events> events{};
+    // sessions that received something this round or still had requests queued after the last one
+    std::vector<int> pending{};
+    std::vector<Session*> ready{};
+    bool running = true;
+    while (running) {
+        int n = epoll_wait(server.epoll(), events.data(), max_events, pending.empty() ? -1 : 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw_errno("epoll_wait");
+        }
+        for (int i = 0; i < n; i++) {
+            const int fd = events[i].data.fd;
+            if (fd == listener.get()) {
+                server.accept_all(listener.get());
+            } else if (fd == signal_fd.get()) {
+                running = false;
+            } else if (Session* session = server.session(fd)) {
+                bool alive = (events[i].events & EPOLLOUT) == 0 || server.flush(*session);
+                if (alive && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0) alive = server.receive(*session);
+                if (!alive || (session->closing && session->out.empty())) {
+                    server.drop(fd);
+                } else {
+                    pending.push_back(fd);
+                }
+            }
+        }
+        if (!running) break;
+
+        // one request per session per round, the next one is handled once its reply is out
+        std::ranges::sort(pending);
+        auto [first, last] = std::ranges::unique(pending);
+        pending.erase(first, last);
+        ready.clear();
+        for (int fd : pending) {
+            Session* session = server.session(fd);
+            if (session == nullptr || session->closing) continue;
+            // served again once the replies it has drain
+            if (session->out.size() >= max_pending_output) continue;
+            size_t end = session->in.find('\n');
+            if (end == std::string::npos || end > max_request_line) {
+                if (std::min(end, session->in.size()) > max_request_line) {
+                    session->out += "error line too long\n";
+                    session->closing = true;
+                    ready.push_back(session);
+                }
+                continue;
+            }
+            session->request.assign(session->in, 0, end);
+            session->in.erase(0, end + 1);
+            std::string_view line = session->request;
+            if (next_token(line) == "new"sv) {
+                // the contexts are built here, on the loop thread, before any worker needs them
+                auto strategy = parse_strategy(next_token(line), default_strategy);
+                if (strategy.has_value() && contexts[static_cast<size_t>(*strategy)] == nullptr)
+                    contexts[static_cast<size_t>(*strategy)] = &context(*strategy);
+            }
+            ready.push_back(session);
+        }
+        pool.parallel_for(0, ready.size(), 1, [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                Session& session = *ready[i];
+                if (session.request.empty() && session.closing) continue;
+                try {
+                    handle(session, contexts, default_strategy);
+                } catch (const std::exception& e) {
+                    // e.g. feedback that no word fits, the game can't go on
+                    session.out += "error ";
+                    session.out += e.what();
+                    session.out += '\n';
+                    session.game.reset();
+                }
+                session.request.clear();
+            }
+        });
+        pending.clear();
+        for (Session* session : ready) {
+            const int fd = session->fd.get();
+            if (!server.flush(*session) || (session->closing && session->out.empty())) {
+                server.drop(fd);
+            } else if (session->has_request()) {
+                pending.push_back(fd);
+            }
+        }
+    }
+    const auto current = file_status(addr.sun_path);
+    if (bound && current && current->st_dev == bound->st_dev && current->st_ino == bound->st_ino)
+        ::unlink(addr.sun_path);
+}
+
+namespace {
+    // blocking line based connection for the stand-in client
+    class Connection {
+        FileDescriptor m_fd;
+        std::string m_in{};
+
+        public:
+        explicit Connection(std::string_view socket_path) : m_fd(::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) {
+            if (m_fd.get() < 0) throw_errno("socket");
+            const sockaddr_un addr = socket_address(socket_path);
+            if (::connect(m_fd.get(), reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0)
+                throw_errno("connect");
+        }
+
+        // sends the request and returns the reply line, without its newline
+        std::string request(std::string_view line) {
+            std::string message{line};
+            message += '\n';
+            for (size_t sent = 0; sent < message.size();) {
+                ssize_t n = ::send(m_fd.get(), message.data() + sent, message.size() - sent, MSG_NOSIGNAL);
+                if (n < 0 && errno != EINTR) throw_errno("send");
+                if (n > 0) sent += static_cast<size_t>(n);
+            }
+            size_t end = 0;
+            while ((end = m_in.find('\n')) == std::string::npos) {
+                char buffer[read_chunk];
+                ssize_t n = ::recv(m_fd.get(), buffer, sizeof(buffer), 0);
+                if (n == 0) throw std::runtime_error("The server closed the connection");
+                if (n < 0 && errno != EINTR) throw_errno("recv");
+                if (n > 0) m_in.append(buffer, static_cast<size_t>(n));
+            }
+            std::string reply = m_in.substr(0, end);
+            m_in.erase(0, end + 1);
+            return reply;
+        }
+    };
+
+    void play_days(std::string_view socket_path, std::span<const std::string_view> solutions, size_t first,
+                   size_t end, size_t step, std::string_view new_request, ClientResult& result) {
+        using std::chrono::steady_clock;
+        Connection connection{socket_path};
+        auto timed = [&](std::string_view line) {
+            const auto start = steady_clock::now();
+            std::string reply = connection.request(line);
+            result.turn_latencies.push_back(steady_clock::now() - start);
+            return reply;
+        };
+        for (size_t day = first; day < end; day += step) {
+            const auto start = steady_clock::now();
+            std::string reply = timed(new_request);
+            while (reply.starts_with("guess "sv)) {
+                CharState states[PackedDictionary::word_size]{};
+                decode_pattern(compute_pattern(std::string_view{reply}.substr(6), solutions[day]), states);
+                std::string feedback{"feedback "};
+                for (CharState state : states)
+                    feedback += static_cast<char>('0' + static_cast<int>(state));
+                reply = timed(feedback);
+            }
+            if (reply.starts_with("solved "sv)) {
+                result.games.add(std::stoul(reply.substr(7)), true);
+            } else if (reply == "lost"sv) {
+                result.games.add(Board::max_guesses(), false);
+                result.games.failed_days.push_back(day);
+            } else {
+                throw std::runtime_error("Unexpected reply from the server: " + reply);
+            }
+            result.games.latencies.push_back(steady_clock::now() - start);
+        }
+        connection.request("quit"sv);
+    }
+}
+
+ClientResult run_client(std::string_view socket_path, std::span<const std::string_view> solutions, size_t start,
+                        size_t end, size_t n_connections, Strategy strategy) {
+    const std::string new_request = strategy == Strategy::Entropy ? "new entropy" : "new heuristic";
+    n_connections = std::clamp<size_t>(n_connections, 1, std::max<size_t>(end - start, 1));
+    std::vector<ClientResult> results(n_connections);
+    std::vector<std::exception_ptr> errors(n_connections);
+    {
+        std::vector<std::jthread> threads{};
+        for (size_t c = 0; c < n_connections; c++) {
+            threads.emplace_back([&, c] {
+                try {
+                    play_days(socket_path, solutions, start + c, end, n_connections, new_request, results[c]);
+                } catch (...) {
+                    errors[c] = std::current_exception();
+                }
+            });
+        }
+    }
+    ClientResult total{};
+    for (size_t c = 0; c < n_connections; c++) {
+        if (errors[c]) std::rethrow_exception(errors[c]);
+        total.games.merge(results[c].games);
+        total.turn_latencies.insert(total.turn_latencies.end(), results[c].turn_latencies.begin(),
+                                    results[c].turn_latencies.end());
+    }
+    return total;
+}
+#else
+void run_server(std::string_view, size_t, Strategy, const std::function<const SolverContext&(Strategy)>&) {
+    throw std::runtime_error("The solver daemon is only supported on Linux");
+}
+
+ClientResult run_client(std::string_view, std::span<const std::string_view>, size_t, size_t, size_t, Strategy) {
+    throw std::runtime_error("The solver daemon is only supported on Linux");
+}
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+#include "Batch.h"
+#include "Sweep.h"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// Solver daemon on a Unix domain socket (Linux only). Every connection is an interactive session with its own
+// Board and Solver, the dictionary and everything built from it are shared. The protocol is line based:
+//     new [heuristic|entropy]   starts a game, answers "guess <word>"
+//     feedback <digits>         feedback for the last guess, one digit per letter: 0 grey, 1 yellow, 2 green.
+//                               Answers "guess <word>", "solved <guesses>" or "lost"
+//     quit                      answers "bye" and closes the connection
+// Anything else gets "error <reason>". Connections are served by an epoll loop, the requests that are ready are
+// solved together on a pool of n_threads workers (0 means one per hardware thread). Runs until SIGINT or SIGTERM.
+// context(strategy) is only called from the loop thread, the first time a session asks for the strategy.
+void run_server(std::string_view socket_path, size_t n_threads, Strategy default_strategy,
+                const std::function<const SolverContext&(Strategy)>& context);
+
+struct ClientResult {
+    GuessData games{};
+    // round trip of every request
+    std::vector<std::chrono::nanoseconds> turn_latencies{};
+};
+
+// Stand-in client: plays the days [start, end) with the given strategy against a running server, over n_connections
+// concurrent sessions, giving the feedback itself.
+ClientResult run_client(std::string_view socket_path, std::span<const std::string_view> solutions, size_t start,
+                        size_t end, size_t n_connections, Strategy strategy);
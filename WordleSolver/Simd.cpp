@@ -0,0 +1,30 @@
+#include "Simd.h"
+#if WS_HAS_X86 && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+bool cpu_has_avx2() noexcept {
+#if WS_HAS_X86 && defined(_MSC_VER) && !defined(__clang__)
+    static const bool supported = [] {
+        int regs[4]{};
+        __cpuid(regs, 0);
+        if (regs[0] < 7) return false;
+        __cpuid(regs, 1);
+        constexpr int osxsave = 1 << 27;
+        constexpr int avx = 1 << 28;
+        if ((regs[2] & (osxsave | avx)) != (osxsave | avx)) return false;
+        // the OS has to save the ymm registers on context switches
+        if ((_xgetbv(0) & 0x6) != 0x6) return false;
+        __cpuidex(regs, 7, 0);
+        constexpr int avx2 = 1 << 5;
+        constexpr int bmi1 = 1 << 3;
+        return (regs[1] & (avx2 | bmi1)) == (avx2 | bmi1);
+    }();
+    return supported;
+#elif WS_HAS_X86
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi");
+    return supported;
+#else
+    return false;
+#endif
+}
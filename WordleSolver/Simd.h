@@ -0,0 +1,17 @@
+#pragma once
+
+// x86 kernels are compiled for AVX2 with a per-function target attribute and picked at runtime,
+// so the executable still runs (on the scalar paths) on machines without AVX2
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define WS_HAS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define WS_TARGET_AVX2
+#else
+#define WS_TARGET_AVX2 __attribute__((target("avx2,bmi,popcnt")))
+#endif
+#else
+#define WS_HAS_X86 0
+#endif
+
+bool cpu_has_avx2() noexcept;
@@ -1,139 +1,339 @@
 #include "Solver.h"
+#include <bit>
+#include <cassert>
+#include <stdexcept>
 
 namespace r = std::ranges;
 constexpr size_t npos = std::string_view::npos;
 
-SolverFilter::SolverFilter(Solver& s) : solver(s) {}
+template <size_t N, size_t G>
+BasicSolverFilter<N, G>::BasicSolverFilter(BasicSolver<N, G>& s) : solver(s) {}
 
-bool SolverFilter::operator()(const WordView& wordt) {
+template <size_t N, size_t G>
+Rejection BasicSolverFilter<N, G>::reject_reason(const WordView& wordt) {
     const auto& word = wordt.word;
     const auto& alphabet = solver.alphabet;
-    using enum Solver::GuessState;
+    using enum GuessState;
 
     if ((solver.alphabet_mask & wordt.word_mask) != WordMask::NOLETTER) {
         dbg("Excluding " << word << " because it had a character that's not in the solution\n");
-        return false;
+        return Rejection::ForbiddenLetter;
     }
     if (r::find(solver.m_history, word) != solver.m_history.end()) {
         dbg("Excluding " << word << " because it has already been guessed\n");
-        return false;
+        return Rejection::AlreadyGuessed;
     }
+    // the letters are read from the packed code and their presence from the mask, the string is only printed
+    const auto code = pack_word<N>(word);
+    const uint32_t mask = from_enum(wordt.word_mask);
     for (size_t i = 0; i < alphabet.size(); i++) {
         const auto& entry = alphabet[i];
-        char letter = static_cast<char>(i + 'a');
+        [[maybe_unused]] char letter = static_cast<char>(i + 'a');
         if ((entry.state & Correct) == Correct) {
             for (auto idx : entry.indexes_correct) {
-                if (word[idx] != letter) {
+                if (code_letter<N>(code, idx) != i) {
                     dbg("Excluding " << word << " because it doesn't have the letter " << letter
                                      << " in the correct spot\n");
-                    return false;
+                    return Rejection::WrongGreen;
                 }
             }
             if ((entry.state & Wrong) == Wrong && (entry.state & Misplaced) == NotGuessed) {
-                size_t idx = word.find(letter);
-                while (idx != npos) {
-                    if (entry.indexes_correct.find(static_cast<uint8_t>(idx)) == npos) {
+                for (size_t idx = 0; idx < N; idx++) {
+                    if (code_letter<N>(code, idx) == i &&
+                        entry.indexes_correct.find(static_cast<uint8_t>(idx)) == npos) {
                         dbg("Excluding " << word << " because it has the letter " << letter
                                          << " in 2 spots, only one of which is correct\n");
-                        return false;
+                        return Rejection::DuplicateLetter;
                     }
-                    idx = word.find(letter, idx + 1);
                 }
             }
         }
         if ((entry.state & Misplaced) == Misplaced) {
             for (auto idx : entry.indexes_misplaced) {
-                if (word[idx] == letter) {
+                if (code_letter<N>(code, idx) == i) {
                     dbg("Excluding " << word << " because it has the letter " << letter << " in the wrong spot\n");
-                    return false;
+                    return Rejection::Misplaced;
                 }
             }
-            if (word.find(letter) == npos) {
+            if (((mask >> i) & 1) == 0) {
                 dbg("Excluding " << word << " because it doesn't have the letter " << letter << '\n');
-                return false;
+                return Rejection::MissingLetter;
             }
         }
     }
     dbg("Including " << word << '\n');
-    return true;
+    return Rejection::None;
 };
 
-Solver::Solver(const std::span<WordView>& dictionary) :
-    m_dictionary(dictionary), m_filtered_view(m_dictionary | std::views::filter(SolverFilter{*this})) {
-    m_filtered_iter = m_filtered_view.end();
+template <size_t N, size_t G>
+BasicSolver<N, G>::BasicSolver(const BasicSolverContext<N>& ctx) :
+    m_dictionary(ctx.dict), m_packed(*ctx.packed), m_index(ctx.index), m_scan_pos(ctx.dict.size()),
+    m_entropy(ctx.entropy), m_hard_mode(ctx.hard_mode), m_strategy(ctx.strategy) {
+    if (m_entropy && N != PatternMatrix::word_size)
+        throw std::runtime_error("The entropy engine only plays words of " + std::to_string(PatternMatrix::word_size) +
+                                 " letters");
+    if (m_index) {
+        m_live.resize(m_index->blocks());
+        m_index->fill(m_live);
+    }
+}
+
+template <size_t N, size_t G>
+auto BasicSolver<N, G>::compile_constraints() const -> constraints_type {
+    using enum GuessState;
+    constraints_type constraints{};
+    constraints.forbidden = from_enum(alphabet_mask);
+    for (size_t i = 0; i < alphabet.size(); i++) {
+        const auto& entry = alphabet[i];
+        const uint32_t letter = 1u << i;
+        if ((entry.state & Correct) == Correct) {
+            for (auto idx : entry.indexes_correct)
+                constraints.banned[idx] |= ~letter;
+            // a letter that was also grey (and never yellow) is only where it's green
+            if ((entry.state & Wrong) == Wrong && (entry.state & Misplaced) == NotGuessed) {
+                for (size_t pos = 0; pos < constraints.banned.size(); pos++) {
+                    if (entry.indexes_correct.find(static_cast<uint8_t>(pos)) == npos) constraints.banned[pos] |= letter;
+                }
+            }
+        }
+        if ((entry.state & Misplaced) == Misplaced) {
+            for (auto idx : entry.indexes_misplaced)
+                constraints.banned[idx] |= letter;
+            constraints.required |= letter;
+        }
+    }
+    return constraints;
+}
+
+template <size_t N, size_t G>
+auto BasicSolver<N, G>::compile_hints() const -> constraints_type {
+    using enum GuessState;
+    constraints_type hints{};
+    for (size_t i = 0; i < alphabet.size(); i++) {
+        const auto& entry = alphabet[i];
+        const uint32_t letter = 1u << i;
+        for (auto idx : entry.indexes_correct)
+            hints.banned[idx] = ~letter;
+        if ((entry.state & Misplaced) == Misplaced) hints.required |= letter;
+    }
+    return hints;
+}
+
+template <size_t N, size_t G>
+bool BasicSolver<N, G>::fits_hints(size_t idx) const {
+    uint8_t letters[N];
+    for (size_t pos = 0; pos < N; pos++)
+        letters[pos] = m_packed.letters(pos)[idx];
+    return m_hints.accepts(m_packed.masks()[idx], letters);
+}
+
+template <size_t N, size_t G>
+void BasicSolver<N, G>::update_candidates(const constraints_type& constraints) {
+    m_index->update(m_applied, constraints, m_live);
+    m_applied = constraints;
+}
+
+template <size_t N, size_t G>
+size_t BasicSolver<N, G>::next_filtered(size_t begin) {
+    const constraints_type constraints = compile_constraints();
+    auto guessed = [this](size_t idx) { return r::find(m_history, m_dictionary[idx].word) != m_history.end(); };
+    size_t found = m_dictionary.size();
+    if (m_index) {
+        update_candidates(constraints);
+        size_t idx = index_type::find_next(m_live, begin);
+        while (idx != index_type::npos && guessed(idx))
+            idx = index_type::find_next(m_live, idx + 1);
+        if (idx != index_type::npos) found = idx;
+    } else {
+        constexpr size_t chunk_size = 256;
+        uint32_t survivors[chunk_size];
+        for (size_t start = begin; start < m_dictionary.size() && found == m_dictionary.size(); start += chunk_size) {
+            size_t n = filter_words(m_packed, constraints, start, std::min(start + chunk_size, m_dictionary.size()),
+                                    survivors);
+            for (size_t k = 0; k < n; k++) {
+                if (!guessed(survivors[k])) {
+                    found = survivors[k];
+                    break;
+                }
+            }
+        }
+    }
+    assert(found == static_cast<size_t>(std::find_if(m_dictionary.begin() + begin, m_dictionary.end(),
+                                                     BasicSolverFilter<N, G>{*this}) - m_dictionary.begin()));
+    STAT_ONLY(count_scan(begin, found));
+    if (found == m_dictionary.size()) throw std::runtime_error("No word in the dictionary fits the feedback");
+    return found;
+}
+
+template <size_t N, size_t G>
+void BasicSolver<N, G>::count_scan(size_t begin, size_t found) {
+    // the kernel and the index don't know why a word fails, the per-word filter does
+    BasicSolverFilter<N, G> filter{*this};
+    auto& counters = solver_stats::local();
+    for (size_t i = begin; i < found; i++) {
+        Rejection reason = filter.reject_reason(m_dictionary[i]);
+        if (reason != Rejection::None) counters.rejected[static_cast<size_t>(reason)]++;
+    }
+    const uint64_t visited = std::min(found + 1, m_dictionary.size()) - begin;
+    counters.scans++;
+    counters.words_visited += visited;
+    counters.max_words_visited = std::max(counters.max_words_visited, visited);
+}
+
+template <size_t N, size_t G>
+auto BasicSolver<N, G>::next_guess_special(word_iter begin, word_iter end) -> opt_ref {
+    uint32_t used_letters = 0;
+    for (size_t i = 0; i < alphabet.size(); i++)
+        used_letters |= static_cast<uint32_t>(alphabet[i].state != GuessState::NotGuessed) << i;
+    const size_t from = static_cast<size_t>(begin - m_dictionary.begin());
+    const size_t to = static_cast<size_t>(end - m_dictionary.begin());
+    size_t idx = to;
+    if (m_index) {
+        idx = std::min(m_index->find_fresh(used_letters, from), to);
+    } else {
+        // N distinct letters none of which was tried, straight from the mask column
+        const uint32_t* masks = m_packed.masks();
+        for (idx = from; idx < to; idx++) {
+            if (std::popcount(masks[idx]) == static_cast<int>(N) && (masks[idx] & used_letters) == 0) break;
+        }
+    }
+    if (idx == to) {
+        STAT_ADD(special_misses, 1);
+        return std::nullopt;
+    }
+    STAT_ADD(special_hits, 1);
+    return {m_dictionary[idx]};
 }
 
-Solver::opt_ref Solver::next_guess_special(Solver::word_iter begin, Solver::word_iter end) {
-    auto iter = std::find_if(begin, end, [&](const WordView& view) {
-        WordMask encountered = WordMask::NOLETTER;
-        bool has_double = false;
-        for (auto c : view.word) {
-            auto val = to_enum<WordMask>(1 << (c - 'a'));
-            if ((encountered & val) != WordMask::NOLETTER) {
-                has_double = true;
-                break;
+template <size_t N, size_t G>
+size_t BasicSolver<N, G>::next_guess_entropy(const board_type& board) {
+    const size_t turn = board.guesses();
+    if (turn == 0) return m_entropy->opener();
+
+    if constexpr (N == PatternMatrix::word_size) {
+        if (m_hard_mode) {
+            // the probes are restricted to the words using the hints
+            if (m_index) {
+                m_allowed.resize(m_index->blocks());
+                m_index->fill(m_allowed);
+                m_index->narrow(m_hints, m_allowed);
+            } else {
+                m_allowed.assign((m_dictionary.size() + 63) / 64, 0);
+                constexpr size_t chunk_size = 256;
+                uint32_t survivors[chunk_size];
+                for (size_t start = 0; start < m_dictionary.size(); start += chunk_size) {
+                    size_t n = filter_words(m_packed, m_hints, start, std::min(start + chunk_size, m_dictionary.size()),
+                                            survivors);
+                    for (size_t k = 0; k < n; k++)
+                        m_allowed[survivors[k] / 64] |= uint64_t{1} << (survivors[k] % 64);
+                }
             }
-            encountered |= val;
         }
-        if (has_double) return false;
-        return !std::any_of(view.word.begin(), view.word.end(),
-                            [&](char c) { return alphabet[c - 'a'].state != GuessState::NotGuessed; });
-    });
-    if (iter == end) { return std::nullopt; }
-    return {*iter};
+        pattern_t feedback = encode_pattern(board.board()[turn - 1]);
+        auto row = m_entropy->patterns().row(m_history_idx[turn - 1]);
+        if (turn == 1) {
+            for (size_t i = 0; i < row.size(); i++) {
+                if (row[i] == feedback) m_candidates.push_back(static_cast<candidate_t>(i));
+            }
+            return m_entropy->best_probe(m_candidates, feedback, m_allowed);
+        }
+        std::erase_if(m_candidates, [&](candidate_t c) { return row[c] != feedback; });
+        return m_entropy->best_probe(m_candidates, std::nullopt, m_allowed);
+    } else {
+        // the constructor doesn't let an entropy engine in
+        return m_entropy->opener();
+    }
+}
+
+template <size_t N, size_t G>
+size_t BasicSolver<N, G>::next_guess_strategy(const board_type& board) {
+    const size_t turn = board.guesses();
+    if (turn > 0) {
+        m_node = m_strategy->child(m_node, encode_pattern(board.board()[turn - 1]));
+        if (m_node == StrategyTree::npos) throw std::runtime_error("The strategy tree has no guess for this feedback");
+    }
+    return m_strategy->guess(m_node);
+}
+
+template <size_t N, size_t G>
+void BasicSolver<N, G>::learn(const board_type& board) {
+    const auto& m = board.board();
+    const auto& prev_guess_row = m[board.guesses() - 1];
+    const auto& prev_guess = m_history[board.guesses() - 1];
+
+    // store information gathered from previous guess
+    for (size_t i = 0; i < array_size(prev_guess_row); i++) {
+        using enum GuessState;
+        size_t index = static_cast<size_t>(prev_guess[i] - 'a');
+        auto& entry = alphabet[index];
+        switch (prev_guess_row[i]) {
+        case CharState::Wrong:
+            alphabet_mask |= to_enum<WordMask>((entry.state == NotGuessed) << index);
+            entry.state |= Wrong;
+            break;
+        case CharState::Misplaced:
+            alphabet_mask &= to_enum<WordMask>(~(1 << index));
+            entry.state |= Misplaced;
+            entry.indexes_misplaced.push_back(i);
+            break;
+        case CharState::Correct:
+            alphabet_mask &= to_enum<WordMask>(~(1 << index));
+            entry.state |= Correct;
+            entry.indexes_correct.push_back(i);
+            break;
+        }
+    }
+    // what hard mode checks every guess against until the next feedback
+    if (m_hard_mode) m_hints = compile_hints();
 }
 
-std::tuple<std::string_view, bool> Solver::next_guess(const Board& board) {
+template <size_t N, size_t G>
+void BasicSolver<N, G>::record(const board_type& board, guess_t guess) {
+    m_history[board.guesses()] = std::get<std::string_view>(guess);
+    m_history_idx[board.guesses()] = std::get<size_t>(guess);
+}
+
+template <size_t N, size_t G>
+guess_t BasicSolver<N, G>::next_guess(const board_type& board) {
     std::string_view guess;
+    size_t guess_idx = 0;
     bool special_guess = false;
-    if (board.guesses() == 0) {
+    STAT_ADD(next_guess_calls, 1);
+    if (m_strategy) {
+        guess_idx = next_guess_strategy(board);
+        guess = m_dictionary[guess_idx].word;
+    } else if (m_entropy) {
+        if (m_hard_mode && board.guesses() > 0) learn(board);
+        guess_idx = next_guess_entropy(board);
+        guess = m_dictionary[guess_idx].word;
+    } else if (board.guesses() == 0) {
         guess = m_dictionary.front().word;
     } else {
-        const auto& m = board.board();
-        const auto& prev_guess_row = m[board.guesses() - 1];
-        const auto& prev_guess = m_history[board.guesses() - 1];
-
-        // store information gathered from previous guess
-        for (size_t i = 0; i < array_size(prev_guess_row); i++) {
-            using enum GuessState;
-            size_t index = static_cast<size_t>(prev_guess[i] - 'a');
-            auto& entry = alphabet[index];
-            switch (prev_guess_row[i]) {
-            case CharState::Wrong:
-                alphabet_mask |= to_enum<WordMask>((entry.state == NotGuessed) << index);
-                entry.state |= Wrong;
-                break;
-            case CharState::Misplaced:
-                alphabet_mask &= to_enum<WordMask>(~(1 << index));
-                entry.state |= Misplaced;
-                entry.indexes_misplaced.push_back(i);
-                break;
-            case CharState::Correct:
-                alphabet_mask &= to_enum<WordMask>(~(1 << index));
-                entry.state |= Correct;
-                entry.indexes_correct.push_back(i);
-                break;
-            }
-        }
+        learn(board);
 
         if (!board.info_obtained() && board.guesses() < board.max_guesses() - 1) {
-            auto wordview = next_guess_special(m_filtered_iter.base(), m_dictionary.end());
+            auto wordview = next_guess_special(m_dictionary.begin() + m_scan_pos, m_dictionary.end());
             if (wordview.has_value()) {
                 guess = wordview->get().word;
-                special_guess = true;
+                guess_idx = static_cast<size_t>(&wordview->get() - m_dictionary.data());
+                // a word of letters not tried yet only uses the hints if there are none
+                special_guess = !m_hard_mode || fits_hints(guess_idx);
             }
         }
         if (!special_guess) {
-            if (m_filtered_iter == m_filtered_view.end()) {
-                m_filtered_iter = m_filtered_view.begin();
-                auto& wordview = (*m_filtered_iter);
-                guess = wordview.word;
-            } else {
-                auto& wordview = (*++m_filtered_iter);
-                guess = wordview.word;
-            }
+            m_scan_pos = next_filtered(m_scan_pos == m_dictionary.size() ? 0 : m_scan_pos + 1);
+            guess = m_dictionary[m_scan_pos].word;
+            guess_idx = m_scan_pos;
         }
     }
-    m_history[board.guesses()] = guess;
-    return {guess, special_guess};
+    assert(!m_hard_mode || fits_hints(guess_idx));
+    record(board, {guess, special_guess, guess_idx});
+    return {guess, special_guess, guess_idx};
 }
+
+#define WS_INSTANTIATE_SOLVER(N)                                                                                       \
+    template class BasicSolverFilter<N, static_max_guesses>;                                                           \
+    template class BasicSolver<N, static_max_guesses>;                                                                 \
+    template class BasicSolverFilter<N, multi_max_guesses>;                                                            \
+    template class BasicSolver<N, multi_max_guesses>;
+WS_FOR_EACH_WORD_SIZE(WS_INSTANTIATE_SOLVER)
@@ -1,5 +1,11 @@
 #pragma once
 #include "Board.h"
+#include "CandidateIndex.h"
+#include "EntropyScorer.h"
+#include "FilterKernel.h"
+#include "PackedDictionary.h"
+#include "SolverStats.h"
+#include "StrategyTree.h"
 #include "data/DictionaryLoader.h"
 #include <algorithm>
 #include <array>
@@ -11,31 +17,59 @@
 #include <string_view>
 #include <vector>
 
-class Solver;
+// read-only state shared by every game, built once per dictionary of N letter words
+template <size_t N>
+struct BasicSolverContext {
+    std::span<const std::string_view> solutions;
+    std::span<const WordView> dict;
+    const BasicPackedDictionary<N>* packed = nullptr;
+    // when set, the words that fit the feedback are kept as a bitset instead of being rescanned with the kernel
+    const BasicCandidateIndex<N>* index = nullptr;
+    // the pattern table and the entropy engine only exist for words of PatternMatrix::word_size letters
+    const PatternMatrix* patterns = nullptr;
+    const EntropyScorer* entropy = nullptr;
+    // every guess has to use the hints revealed so far: greens in their spot, yellows anywhere
+    bool hard_mode = false;
+    // when set the guesses come from the tree instead of an engine
+    const StrategyTree* strategy = nullptr;
+};
+
+// what the feedback so far says about a letter, a combination of the flags of every time it was guessed
+enum class GuessState : uint8_t { NotGuessed = 0, Wrong = 1, Misplaced = 2, Correct = 4 };
 
-class SolverFilter {
-    Solver& solver;
+// Per-word version of the filter kernel, reads the solver state directly. Used to validate the kernel.
+template <size_t N, size_t G>
+class BasicSolverFilter {
+    BasicSolver<N, G>& solver;
 
     public:
-    SolverFilter(Solver& s);
-    bool operator()(const WordView& wordt);
+    BasicSolverFilter(BasicSolver<N, G>& s);
+    // the first check the word fails, Rejection::None if it fits
+    Rejection reject_reason(const WordView& wordt);
+    bool operator()(const WordView& wordt) { return reject_reason(wordt) == Rejection::None; }
 };
 
-class Solver {
-    friend SolverFilter;
-    const std::span<WordView>& m_dictionary;
-    std::array<std::string_view, Board::max_guesses()> m_history;
+template <size_t N, size_t G>
+class BasicSolver {
+    friend BasicSolverFilter<N, G>;
+    using board_type = BasicBoard<N, G>;
+    using index_type = BasicCandidateIndex<N>;
+    using constraints_type = BasicFilterConstraints<N>;
 
-    using word_iter = std::span<WordView>::iterator;
-    using opt_ref = std::optional<std::reference_wrapper<WordView>>;
+    const std::span<const WordView>& m_dictionary;
+    const BasicPackedDictionary<N>& m_packed;
+    const index_type* m_index;
+    std::array<std::string_view, board_type::max_guesses()> m_history;
+    std::array<size_t, board_type::max_guesses()> m_history_idx{};
 
-    enum class GuessState : uint8_t { NotGuessed = 0, Wrong = 1, Misplaced = 2, Correct = 4 };
+    using word_iter = std::span<const WordView>::iterator;
+    using opt_ref = std::optional<std::reference_wrapper<const WordView>>;
 
     struct LetterState {
         GuessState state;
 
         // using std::basic_string enables the use of SSO, avoiding allocation
-        // since the inline buffer is more than 5 bytes, this is guaranteed to work and never allocate
+        // since the inline buffer is more than max_word_size bytes, this is guaranteed to work and never allocate
         using bytebuffer = std::basic_string<uint8_t>;
 
         bytebuffer indexes_misplaced{};
@@ -48,14 +82,55 @@ class Solver {
 
     WordMask alphabet_mask = WordMask::NOLETTER;
 
-    decltype(m_dictionary | std::views::filter(std::declval<SolverFilter>())) m_filtered_view;
-    decltype(std::declval<decltype(m_filtered_view)>().begin()) m_filtered_iter;
+    // dictionary index of the last word picked by the filter, m_dictionary.size() until the first one
+    size_t m_scan_pos;
+    // words that satisfy m_applied, only kept with an index
+    std::vector<typename index_type::block_t> m_live{};
+    constraints_type m_applied{};
+
+    // only used by the entropy engine: the scorer and the solutions still consistent with the feedback
+    const EntropyScorer* m_entropy;
+    std::vector<candidate_t> m_candidates{};
+
+    // hard mode only: the hints compiled after every turn, and the dictionary words using them (entropy probes)
+    bool m_hard_mode;
+    constraints_type m_hints{};
+    std::vector<uint64_t> m_allowed{};
+
+    // only used with a strategy tree: the node of the guess picked last
+    const StrategyTree* m_strategy;
+    uint32_t m_node = StrategyTree::root();
 
     opt_ref next_guess_special(word_iter begin, word_iter end);
+    size_t next_guess_entropy(const board_type&);
+    size_t next_guess_strategy(const board_type&);
+    size_t next_filtered(size_t begin);
+    void update_candidates(const constraints_type& constraints);
+    constraints_type compile_hints() const;
+    bool fits_hints(size_t idx) const;
+    // stats builds only: why the words a filter scan went past were rejected
+    void count_scan(size_t begin, size_t found);
 
     public:
-    Solver(const std::span<WordView>& dictionary);
+    BasicSolver(const BasicSolverContext<N>& ctx);
 
+    // what the heuristic engine knows so far, in the form the filter kernel and the index take
+    constraints_type compile_constraints() const;
     std::string_view history(size_t idx) const { return m_history[idx]; }
-    std::tuple<std::string_view, bool> next_guess(const Board&);
-};
\ No newline at end of file
+    // words of the dictionary that fitted the feedback when the last guess was picked, needs an index
+    size_t candidate_count() const { return index_type::count(m_live); }
+    // words of the dictionary that fit the feedback so far, bit i is dictionary word i. Needs an index
+    std::span<const typename index_type::block_t> candidates() {
+        update_candidates(compile_constraints());
+        return m_live;
+    }
+    guess_t next_guess(const board_type&);
+    // takes in the feedback the board got for the guess recorded for its last turn, next_guess does it on its own
+    void learn(const board_type&);
+    // the guess for the board's current turn, for guesses picked elsewhere (the multi-board solver)
+    void record(const board_type&, guess_t guess);
+};
+
+using SolverContext = BasicSolverContext<default_word_size>;
+using SolverFilter = BasicSolverFilter<default_word_size, static_max_guesses>;
+using Solver = BasicSolver<default_word_size>;
\ No newline at end of file
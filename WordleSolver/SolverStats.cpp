@@ -0,0 +1,63 @@
+#include "SolverStats.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace {
+    std::mutex registry_mutex{};
+    // owned here rather than by the threads, so the counts of a finished thread are still in the report
+    std::vector<std::unique_ptr<SolverCounters>> registry{};
+
+    double percent(uint64_t part, uint64_t whole) {
+        return whole == 0 ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(whole);
+    }
+}
+
+void SolverCounters::merge(const SolverCounters& other) {
+    next_guess_calls += other.next_guess_calls;
+    scans += other.scans;
+    words_visited += other.words_visited;
+    max_words_visited = std::max(max_words_visited, other.max_words_visited);
+    for (size_t i = 0; i < rejected.size(); i++)
+        rejected[i] += other.rejected[i];
+    special_hits += other.special_hits;
+    special_misses += other.special_misses;
+}
+
+SolverCounters& solver_stats::local() {
+    thread_local SolverCounters* counters = [] {
+        std::scoped_lock lock{registry_mutex};
+        return registry.emplace_back(std::make_unique<SolverCounters>()).get();
+    }();
+    return *counters;
+}
+
+SolverCounters solver_stats::total() {
+    SolverCounters sum{};
+    std::scoped_lock lock{registry_mutex};
+    for (const auto& counters : registry)
+        sum.merge(*counters);
+    return sum;
+}
+
+void solver_stats::print_report(std::ostream& out) {
+    const SolverCounters sum = total();
+    uint64_t rejected = 0;
+    for (uint64_t n : sum.rejected)
+        rejected += n;
+    out << "Solver counters:\n";
+    out << "    next_guess calls     " << sum.next_guess_calls << '\n';
+    out << "    filter scans         " << sum.scans << ", " << sum.words_visited << " words visited (avg "
+        << (sum.scans ? static_cast<double>(sum.words_visited) / static_cast<double>(sum.scans) : 0.0) << ", max "
+        << sum.max_words_visited << ")\n";
+    out << "    rejected             " << rejected << '\n';
+    for (size_t i = 0; i < rejection_count; i++) {
+        auto name = rejection_name(static_cast<Rejection>(i));
+        out << "        " << name << std::string(21 - name.size(), ' ') << sum.rejected[i] << " ("
+            << percent(sum.rejected[i], rejected) << "%)\n";
+    }
+    out << "    special guesses      " << sum.special_hits << " hits, " << sum.special_misses << " misses\n";
+}
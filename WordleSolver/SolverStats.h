@@ -0,0 +1,63 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+
+// Hot-path counters of the heuristic engine, enabled with -DWORDLESOLVER_STATS=ON in CMake.
+// When disabled the STAT_* macros expand to nothing, so they cost nothing.
+#ifndef WORDLESOLVER_STATS
+#define WORDLESOLVER_STATS 0
+#endif
+
+// why SolverFilter rejects a word, in the order it checks them
+enum class Rejection : uint8_t {
+    ForbiddenLetter,
+    AlreadyGuessed,
+    WrongGreen,
+    DuplicateLetter,
+    Misplaced,
+    MissingLetter,
+    None,
+};
+
+constexpr size_t rejection_count = static_cast<size_t>(Rejection::None);
+
+constexpr std::string_view rejection_name(Rejection reason) {
+    constexpr std::array<std::string_view, rejection_count + 1> names{
+    "forbidden letter", "already guessed", "wrong green", "duplicate letter", "misplaced", "missing letter", "none"};
+    return names[static_cast<size_t>(reason)];
+}
+
+// One block per thread, plain increments, summed when the report is printed
+struct alignas(64) SolverCounters {
+    uint64_t next_guess_calls = 0;
+    // filter scans: how many dictionary words a scan went past (the pick included) before finding the next guess
+    uint64_t scans = 0;
+    uint64_t words_visited = 0;
+    uint64_t max_words_visited = 0;
+    std::array<uint64_t, rejection_count> rejected{};
+    uint64_t special_hits = 0;
+    uint64_t special_misses = 0;
+
+    void merge(const SolverCounters& other);
+};
+
+namespace solver_stats {
+    constexpr bool enabled = WORDLESOLVER_STATS != 0;
+
+    // the calling thread's counters
+    SolverCounters& local();
+    // sum over every thread that counted something, only meaningful while none of them is counting
+    SolverCounters total();
+    void print_report(std::ostream& out);
+}
+
+#if WORDLESOLVER_STATS
+#define STAT_ADD(field, n) (::solver_stats::local().field += (n))
+#define STAT_ONLY(stmt) stmt
+#else
+#define STAT_ADD(field, n) ((void)0)
+#define STAT_ONLY(stmt)
+#endif
@@ -0,0 +1,353 @@
+#include "StrategySearch.h"
+#include "Partition.h"
+#include "PatternMatrix.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    using cost_t = uint64_t;
+    // cost of a state no tree solves with the guesses left, more than all the games of any real tree
+    constexpr cost_t infeasible = cost_t{1} << 40;
+    constexpr size_t max_depth = Board::max_guesses();
+    constexpr uint32_t npos = StrategyTree::npos;
+    // below this many solutions the groups are counted by walking the solutions instead of with count_feedback
+    constexpr size_t sparse_group_limit = 256;
+
+    // fewest guesses k solutions can take in total with the given guesses left: at best one of them is guessed
+    // right away and the others take 2 guesses each
+    constexpr cost_t group_bound(size_t k, size_t left) {
+        if (k == 1) return left >= 1 ? 1 : infeasible;
+        return left >= 2 ? 2 * k - 1 : infeasible;
+    }
+
+    struct StateKey {
+        uint64_t hash;
+        uint64_t check;
+        uint32_t size;
+        uint32_t left;
+
+        bool operator==(const StateKey&) const = default;
+    };
+
+    struct StateKeyHash {
+        size_t operator()(const StateKey& key) const noexcept { return static_cast<size_t>(key.hash); }
+    };
+
+    // two independent hashes of the solutions of a state, which the partition always keeps in the same order
+    StateKey make_key(std::span<const candidate_t> set, size_t left) {
+        uint64_t hash = 0x9e3779b97f4a7c15ull;
+        uint64_t check = 14695981039346656037ull;
+        for (candidate_t c : set) {
+            hash = (hash ^ c) * 0xbf58476d1ce4e5b9ull;
+            hash ^= hash >> 31;
+            check = (check ^ c) * 1099511628211ull;
+        }
+        return {hash, check, static_cast<uint32_t>(set.size()), static_cast<uint32_t>(left)};
+    }
+
+    // the exact cost and best probe of a state, or a lower bound on its cost (probe npos) when every probe was cut off
+    struct StateEntry {
+        cost_t cost;
+        uint32_t probe;
+    };
+
+    // shared by all the threads, one lock per shard so they rarely wait on each other
+    class TranspositionTable {
+        static constexpr size_t n_shards = 64;
+
+        struct alignas(64) Shard {
+            std::mutex mutex{};
+            std::unordered_map<StateKey, StateEntry, StateKeyHash> entries{};
+        };
+
+        std::array<Shard, n_shards> m_shards{};
+
+        // the top bits pick the shard, the map buckets use the low ones
+        Shard& shard(const StateKey& key) noexcept { return m_shards[key.hash >> 58]; }
+
+        public:
+        std::optional<StateEntry> find(const StateKey& key) {
+            Shard& s = shard(key);
+            std::scoped_lock lock{s.mutex};
+            auto it = s.entries.find(key);
+            if (it == s.entries.end()) return std::nullopt;
+            return it->second;
+        }
+
+        // an exact cost replaces a bound, a bound only a lower one
+        void store(const StateKey& key, StateEntry entry) {
+            Shard& s = shard(key);
+            std::scoped_lock lock{s.mutex};
+            auto [it, inserted] = s.entries.try_emplace(key, entry);
+            if (!inserted && it->second.probe == npos && (entry.probe != npos || entry.cost > it->second.cost))
+                it->second = entry;
+        }
+
+        size_t size() {
+            size_t total = 0;
+            for (auto& s : m_shards) {
+                std::scoped_lock lock{s.mutex};
+                total += s.entries.size();
+            }
+            return total;
+        }
+    };
+
+    struct RankedProbe {
+        cost_t bound;
+        uint32_t probe;
+    };
+
+    // what a state needs while its probes are tried, one per depth since the groups are searched depth first
+    struct Level {
+        Partition partition{};
+        std::vector<RankedProbe> ranked{};
+    };
+
+    // per thread
+    struct Scratch {
+        std::array<Level, max_depth + 1> levels{};
+        std::array<uint16_t, pattern_count> hist{};
+        std::array<uint32_t, pattern_count> counts{};
+        size_t states = 0;
+    };
+
+    class StrategySearch {
+        const SolverContext& m_ctx;
+        const PatternMatrix& m_patterns;
+        std::vector<uint32_t> m_solution_rows;
+        size_t m_width;
+        TranspositionTable m_table{};
+
+        // a solution whose feedback tells all the others apart, nothing beats guessing it. npos if there's none
+        uint32_t perfect_probe(std::span<const candidate_t> set, Scratch& scratch) const {
+            auto& hist = scratch.hist;
+            for (candidate_t c : set) {
+                const PatternRow row = m_patterns.row(m_solution_rows[c]);
+                bool distinct = true;
+                for (candidate_t other : set)
+                    distinct &= ++hist[row[other]] == 1;
+                for (candidate_t other : set)
+                    hist[row[other]] = 0;
+                if (distinct) return m_solution_rows[c];
+            }
+            return npos;
+        }
+
+        // The probes worth trying for a state, best bound first and cut to the search width. Probes that leave the
+        // solutions in one group or leave a group that can't be solved with the guesses left are skipped.
+        void rank(std::span<const candidate_t> set, size_t left, Scratch& scratch,
+                  std::vector<RankedProbe>& ranked) const {
+            ranked.clear();
+            const size_t n = set.size();
+            for (size_t probe = 0; probe < m_patterns.rows(); probe++) {
+                const auto row = m_patterns.row(probe);
+                cost_t bound = n;
+                size_t largest = 0;
+                if (n >= sparse_group_limit) {
+                    count_feedback(row, set, scratch.counts);
+                    for (size_t p = 0; p < pattern_count; p++) {
+                        const size_t k = scratch.counts[p];
+                        if (k == 0) continue;
+                        largest = std::max(largest, k);
+                        if (p != solved_pattern) bound += group_bound(k, left - 1);
+                    }
+                } else {
+                    auto& hist = scratch.hist;
+                    for (candidate_t c : set)
+                        hist[row[c]]++;
+                    for (candidate_t c : set) {
+                        uint16_t& k = hist[row[c]];
+                        if (k == 0) continue;
+                        largest = std::max<size_t>(largest, k);
+                        if (row[c] != solved_pattern) bound += group_bound(k, left - 1);
+                        k = 0;
+                    }
+                }
+                if (largest < n && bound < infeasible) ranked.push_back({bound, static_cast<uint32_t>(probe)});
+            }
+            auto better = [](const RankedProbe& a, const RankedProbe& b) {
+                return a.bound < b.bound || (a.bound == b.bound && a.probe < b.probe);
+            };
+            if (m_width != 0 && ranked.size() > m_width) {
+                std::partial_sort(ranked.begin(), ranked.begin() + static_cast<ptrdiff_t>(m_width), ranked.end(),
+                                  better);
+                ranked.resize(m_width);
+            } else {
+                std::ranges::sort(ranked, better);
+            }
+        }
+
+        // total guesses of the state with the probe as the next guess, stops as soon as it reaches limit
+        cost_t evaluate(std::span<const candidate_t> set, size_t left, const RankedProbe& ranked, cost_t limit,
+                        Partition& partition, Scratch& scratch) {
+            partition.split(&m_patterns, m_ctx.solutions, {{}, false, ranked.probe}, set);
+            cost_t cost = ranked.bound;
+            for (size_t p = 0; p < pattern_count; p++) {
+                auto group = partition.bucket(p);
+                if (p == solved_pattern || group.size() < 2) continue;
+                const cost_t group_lb = group_bound(group.size(), left - 1);
+                cost += search(group, left - 1, limit - (cost - group_lb), scratch) - group_lb;
+                if (cost >= limit) break;
+            }
+            return cost;
+        }
+
+        public:
+        StrategySearch(const SolverContext& ctx, size_t width) :
+            m_ctx(ctx), m_patterns(*ctx.patterns), m_solution_rows(PatternMatrix::solution_rows(ctx.dict, ctx.solutions)),
+            m_width(width) {}
+
+        TranspositionTable& table() noexcept { return m_table; }
+
+        // Total guesses of the best tree for the solutions with the guesses left. A result of beta or more only means
+        // no tree costs less than beta.
+        cost_t search(std::span<const candidate_t> set, size_t left, cost_t beta, Scratch& scratch) {
+            const size_t n = set.size();
+            // guessing one of them, then the other
+            if (n <= 2) return group_bound(n, left);
+            if (left < 2) return infeasible;
+            scratch.states++;
+            const StateKey key = make_key(set, left);
+            if (auto entry = m_table.find(key); entry && (entry->probe != npos || entry->cost >= beta))
+                return entry->cost;
+            if (uint32_t probe = perfect_probe(set, scratch); probe != npos) {
+                m_table.store(key, {2 * n - 1, probe});
+                return 2 * n - 1;
+            }
+
+            Level& level = scratch.levels[max_depth - left];
+            rank(set, left, scratch, level.ranked);
+            cost_t best = beta;
+            uint32_t best_probe = npos;
+            for (const auto& ranked : level.ranked) {
+                if (ranked.bound >= best) break;
+                const cost_t cost = evaluate(set, left, ranked, best, level.partition, scratch);
+                if (cost < best) {
+                    best = cost;
+                    best_probe = ranked.probe;
+                }
+            }
+            m_table.store(key, {best, best_probe});
+            return best;
+        }
+
+        // search for the first guess: the groups of every probe are searched in parallel, each assuming the others
+        // cost their bound, and the probe is dropped once one of them can't fit. scratch has one entry per worker
+        // plus one for the calling thread
+        cost_t search_root(std::span<const candidate_t> set, size_t left, ThreadPool& pool,
+                           std::vector<Scratch>& scratch) {
+            if (set.size() <= 2 || left < 2) return search(set, left, infeasible, scratch.back());
+            Scratch& own = scratch.back();
+            own.states++;
+            Level& level = own.levels[max_depth - left];
+            rank(set, left, own, level.ranked);
+            cost_t best = infeasible;
+            uint32_t best_probe = npos;
+            std::vector<std::span<const candidate_t>> groups{};
+            std::vector<cost_t> costs{};
+            for (const auto& [bound, probe] : level.ranked) {
+                if (bound >= best) break;
+                level.partition.split(&m_patterns, m_ctx.solutions, {{}, false, probe}, set);
+                groups.clear();
+                for (size_t p = 0; p < pattern_count; p++) {
+                    if (p != solved_pattern && level.partition.size(p) >= 2) groups.push_back(level.partition.bucket(p));
+                }
+                // the largest groups first, the workers steal the small ones at the end
+                std::ranges::stable_sort(groups, std::ranges::greater{}, [](const auto& group) { return group.size(); });
+                costs.assign(groups.size(), 0);
+                std::atomic<bool> cut_off = false;
+                pool.parallel_for(0, groups.size(), 1, [&](size_t worker, size_t begin, size_t end) {
+                    for (size_t i = begin; i < end && !cut_off.load(std::memory_order_relaxed); i++) {
+                        const cost_t group_lb = group_bound(groups[i].size(), left - 1);
+                        const cost_t limit = best - (bound - group_lb);
+                        costs[i] = search(groups[i], left - 1, limit, scratch[worker]) - group_lb;
+                        if (costs[i] + group_lb >= limit) cut_off.store(true, std::memory_order_relaxed);
+                    }
+                });
+                if (cut_off) continue;
+                const cost_t cost = std::accumulate(costs.begin(), costs.end(), bound);
+                if (cost < best) {
+                    best = cost;
+                    best_probe = probe;
+                }
+            }
+            if (best_probe != npos) m_table.store(make_key(set, left), {best, best_probe});
+            return best;
+        }
+
+        // adds the subtree of the best probes for the solutions, searching again where the table only has a bound
+        uint32_t build(StrategyTree& tree, std::span<const candidate_t> set, size_t left, Scratch& scratch) {
+            uint32_t probe = m_solution_rows[set.front()];
+            if (set.size() > 2) {
+                const StateKey key = make_key(set, left);
+                auto entry = m_table.find(key);
+                if (!entry || entry->probe == npos) {
+                    search(set, left, infeasible, scratch);
+                    entry = m_table.find(key);
+                }
+                probe = entry->probe;
+            }
+            Partition partition{};
+            partition.split(&m_patterns, m_ctx.solutions, {{}, false, probe}, set);
+            size_t n_children = 0;
+            for (size_t p = 0; p < pattern_count; p++)
+                n_children += p != solved_pattern && partition.size(p) > 0;
+            const uint32_t node = tree.add_node(probe, n_children);
+            size_t k = 0;
+            for (size_t p = 0; p < pattern_count; p++) {
+                if (p == solved_pattern || partition.size(p) == 0) continue;
+                tree.set_edge(node, k++, static_cast<uint32_t>(p), build(tree, partition.bucket(p), left - 1, scratch));
+            }
+            return node;
+        }
+    };
+
+    size_t tree_depth(const StrategyTree& tree, uint32_t node) {
+        size_t depth = 0;
+        for (size_t p = 0; p < pattern_count; p++) {
+            if (uint32_t child = tree.child(node, p); child != StrategyTree::npos)
+                depth = std::max(depth, tree_depth(tree, child));
+        }
+        return depth + 1;
+    }
+}
+
+StrategyTree search_strategy(const SolverContext& ctx, const SearchOptions& options, ThreadPool& pool,
+                             SearchReport& report) {
+    if (!ctx.patterns) throw std::runtime_error("The strategy search needs the pattern table");
+    const auto start = std::chrono::steady_clock::now();
+    StrategySearch search{ctx, options.width};
+    std::vector<Scratch> scratch(pool.size() + 1);
+    std::vector<candidate_t> all(ctx.solutions.size());
+    std::iota(all.begin(), all.end(), candidate_t{0});
+
+    // the worst case is the fewest guesses any tree fits in, the total is only minimized at that depth
+    size_t left = options.worst_case ? 1 : max_depth;
+    cost_t cost = search.search_root(all, left, pool, scratch);
+    while (cost >= infeasible && left < max_depth)
+        cost = search.search_root(all, ++left, pool, scratch);
+    if (cost >= infeasible) {
+        throw std::runtime_error("No strategy found that solves every solution in " + std::to_string(max_depth) +
+                                 " guesses");
+    }
+
+    StrategyTree tree{};
+    search.build(tree, all, left, scratch.back());
+    report.total_guesses = cost;
+    report.max_guesses = tree_depth(tree, StrategyTree::root());
+    report.states = 0;
+    for (const auto& s : scratch)
+        report.states += s.states;
+    report.table_entries = search.table().size();
+    report.elapsed = std::chrono::steady_clock::now() - start;
+    return tree;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "Solver.h"
+#include "StrategyTree.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <cstddef>
+
+constexpr size_t default_search_width = 8;
+
+struct SearchOptions {
+    // probes tried at every board state, the ones splitting the solutions into the most groups first. 0 tries every
+    // dictionary word, which makes the result optimal but takes hours
+    size_t width = default_search_width;
+    // minimize the guesses of the longest game first and the total only among the trees reaching that
+    bool worst_case = false;
+};
+
+struct SearchReport {
+    size_t total_guesses = 0;
+    size_t max_guesses = 0;
+    // board states searched and how many the transposition table ended up holding
+    size_t states = 0;
+    size_t table_entries = 0;
+    std::chrono::nanoseconds elapsed{};
+};
+
+// Offline search for the strategy tree with the fewest guesses in total over all the solutions, every game within
+// Board::max_guesses(). Depth-first branch and bound: the probes of a state are tried in order of a lower bound
+// computed from the sizes of the groups they split the solutions into (a group of k costs at least 2k - 1 guesses),
+// and a probe is dropped as soon as what its groups cost so far plus the bounds of the rest can't beat the best one.
+// States are keyed by a hash of their solutions in a sharded transposition table shared by all threads, and the groups
+// of every probe of the first guess are searched in parallel on the pool.
+// Needs the pattern table, throws if no tree solves every solution in time.
+StrategyTree search_strategy(const SolverContext& ctx, const SearchOptions& options, ThreadPool& pool,
+                             SearchReport& report);
@@ -0,0 +1,95 @@
+#include "StrategyTree.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace {
+    constexpr char tree_magic[8]{'W', 'S', 'S', 'T', 'R', 'A', 'T', '\0'};
+    constexpr uint32_t tree_version = 1;
+
+    struct TreeHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t header_size;
+        StrategyTree::Key key;
+        uint64_t nodes;
+        uint64_t edges;
+    };
+}
+
+uint32_t StrategyTree::child(uint32_t node, size_t pattern) const noexcept {
+    const Node& n = m_nodes[node];
+    const Edge* begin = m_edges.data() + n.first_edge;
+    const Edge* end = begin + n.n_edges;
+    const Edge* it = std::lower_bound(begin, end, pattern, [](const Edge& e, size_t p) { return e.pattern < p; });
+    return it != end && it->pattern == pattern ? it->child : npos;
+}
+
+uint32_t StrategyTree::add_node(uint32_t guess, size_t n_edges) {
+    m_nodes.push_back({guess, static_cast<uint32_t>(m_edges.size()), static_cast<uint32_t>(n_edges)});
+    m_edges.resize(m_edges.size() + n_edges, Edge{npos, npos});
+    return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+void StrategyTree::set_edge(uint32_t node, size_t k, uint32_t pattern, uint32_t child) noexcept {
+    m_edges[m_nodes[node].first_edge + k] = {pattern, child};
+}
+
+StrategyTree StrategyTree::load(const std::filesystem::path& path, const Key& key, size_t dictionary_size) {
+    StrategyTree tree{};
+    std::error_code ec{};
+    const uint64_t file_size = std::filesystem::file_size(path, ec);
+    if (ec || file_size < sizeof(TreeHeader)) return tree;
+    std::ifstream in{path, std::ios::binary};
+    TreeHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return tree;
+    if (std::memcmp(header.magic, tree_magic, sizeof(tree_magic)) != 0 || header.version != tree_version ||
+        header.header_size != sizeof(TreeHeader) || header.key.lists_hash != key.lists_hash ||
+        header.key.width != key.width || header.key.worst_case != key.worst_case || header.nodes == 0) {
+        return tree;
+    }
+    // the sizes are checked against the file before anything is allocated for them
+    const uint64_t body = file_size - sizeof(TreeHeader);
+    if (header.nodes > body / sizeof(Node) || header.edges > (body - header.nodes * sizeof(Node)) / sizeof(Edge))
+        return tree;
+    tree.m_nodes.resize(header.nodes);
+    tree.m_edges.resize(header.edges);
+    in.read(reinterpret_cast<char*>(tree.m_nodes.data()), static_cast<std::streamsize>(header.nodes * sizeof(Node)));
+    in.read(reinterpret_cast<char*>(tree.m_edges.data()), static_cast<std::streamsize>(header.edges * sizeof(Edge)));
+    // a truncated file or a tree pointing outside itself or the dictionary is treated as stale
+    const bool valid = in && std::ranges::all_of(tree.m_nodes, [&](const Node& n) {
+        return uint64_t{n.first_edge} + n.n_edges <= header.edges && n.guess < dictionary_size;
+    }) && std::ranges::all_of(tree.m_edges, [&](const Edge& e) { return e.child < header.nodes; });
+    if (!valid) return StrategyTree{};
+    return tree;
+}
+
+bool StrategyTree::save(const std::filesystem::path& path, const Key& key) const {
+    TreeHeader header{};
+    std::memcpy(header.magic, tree_magic, sizeof(tree_magic));
+    header.version = tree_version;
+    header.header_size = sizeof(TreeHeader);
+    header.key = key;
+    header.nodes = m_nodes.size();
+    header.edges = m_edges.size();
+
+    // written to a temporary of this run first, like the pattern cache, so a concurrent run never reads half a tree
+    const auto tmp = unique_temp_path(path);
+    std::error_code ec{};
+    {
+        std::ofstream out{tmp, std::ios::binary | std::ios::trunc};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(m_nodes.data()), static_cast<std::streamsize>(size() * sizeof(Node)));
+        out.write(reinterpret_cast<const char*>(m_edges.data()),
+                  static_cast<std::streamsize>(m_edges.size() * sizeof(Edge)));
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) std::filesystem::remove(tmp, ec);
+    return !ec;
+}
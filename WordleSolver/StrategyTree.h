@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+// A complete strategy: the guess for every board state a game can reach, as a tree whose root is the opener and
+// whose edges are the feedback a guess got. Games that end with a guess have no edge for the solved pattern.
+// Guesses are dictionary indices, so a tree only makes sense with the word lists it was built for.
+class StrategyTree {
+    public:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    struct Node {
+        uint32_t guess;
+        // the edges of the node are m_edges[first_edge, first_edge + n_edges), sorted by feedback
+        uint32_t first_edge;
+        uint32_t n_edges;
+    };
+
+    struct Edge {
+        uint32_t pattern;
+        uint32_t child;
+    };
+
+    private:
+    std::vector<Node> m_nodes{};
+    std::vector<Edge> m_edges{};
+
+    public:
+    // what the tree was built for, a cached tree built for anything else is rebuilt
+    struct Key {
+        uint64_t lists_hash;
+        uint32_t width;
+        uint32_t worst_case;
+    };
+
+    static constexpr uint32_t root() noexcept { return 0; }
+    size_t size() const noexcept { return m_nodes.size(); }
+    bool empty() const noexcept { return m_nodes.empty(); }
+    uint32_t guess(uint32_t node) const noexcept { return m_nodes[node].guess; }
+    // the node reached from the given one by the feedback, npos if no game gets that feedback there
+    uint32_t child(uint32_t node, size_t pattern) const noexcept;
+
+    // adds a node with room for its edges and returns its index, the first node added is the root
+    uint32_t add_node(uint32_t guess, size_t n_edges);
+    // the k-th edge of the node, the edges have to be set with the feedback increasing
+    void set_edge(uint32_t node, size_t k, uint32_t pattern, uint32_t child) noexcept;
+
+    // an empty tree if the file doesn't exist, can't be read, wasn't built for the key or guesses words past the end of
+    // the dictionary
+    static StrategyTree load(const std::filesystem::path& path, const Key& key, size_t dictionary_size);
+    // returns false if the file couldn't be written
+    bool save(const std::filesystem::path& path, const Key& key) const;
+};
@@ -0,0 +1,284 @@
+#include "Sweep.h"
+#include "Partition.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+void GuessData::merge(const GuessData& other) {
+    total_guesses += other.total_guesses;
+    guessed += other.guessed;
+    max_guesses = std::max(max_guesses, other.max_guesses);
+    min_guesses = std::min(min_guesses, other.min_guesses);
+    if (distribution.size() < other.distribution.size()) distribution.resize(other.distribution.size());
+    for (size_t i = 0; i < other.distribution.size(); i++)
+        distribution[i] += other.distribution[i];
+    failed += other.failed;
+    failed_days.insert(failed_days.end(), other.failed_days.begin(), other.failed_days.end());
+    latencies.insert(latencies.end(), other.latencies.begin(), other.latencies.end());
+}
+
+std::chrono::nanoseconds latency_percentile(std::span<const std::chrono::nanoseconds> latencies, double p) {
+    if (latencies.empty()) return {};
+    std::vector<std::chrono::nanoseconds> sorted(latencies.begin(), latencies.end());
+    size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    auto nth = sorted.begin() + static_cast<ptrdiff_t>(std::clamp<size_t>(rank, 1, sorted.size()) - 1);
+    std::nth_element(sorted.begin(), nth, sorted.end());
+    return *nth;
+}
+
+template <size_t N>
+bool solve_guess(BasicBoard<N>& b, BasicSolver<N>& s, GuessData& data, BoardOutput output, std::string& out) {
+    const auto start = std::chrono::steady_clock::now();
+    while (!b.solved() && b.guesses() < b.max_guesses()) {
+        b.guess(s.next_guess(b));
+    }
+    data.latencies.push_back(std::chrono::steady_clock::now() - start);
+    bool solved = b.solved();
+    data.add(b.guesses(), solved);
+    if (!solved) data.failed_days.push_back(b.solution_index());
+    if (output == BoardOutput::Compact) {
+        out += b.solution();
+        out += ' ';
+        out += solved ? std::to_string(b.guesses()) : "X";
+        out += '/';
+        out += std::to_string(b.max_guesses());
+        out += ' ';
+        b.render(s, out, output);
+        out += '\n';
+    } else if (output == BoardOutput::Full) {
+        b.render(s, out, output);
+        if (solved) {
+            out += "Solved in " + std::to_string(b.guesses()) + " guesse(s), the word was ";
+        } else {
+            out += "Didn't solve it, the word was ";
+        }
+        out += b.solution();
+        out += "\n\n";
+    }
+    return solved;
+}
+
+template <size_t N>
+GuessData solve_loop(const BasicSolverContext<N>& ctx, size_t start, size_t end, BoardOutput output,
+                     ProgressSlot* progress) {
+    GuessData data{};
+    data.progress = progress;
+    // the games are written out in batches, not a character or a game at a time
+    std::string out{};
+    if (output != BoardOutput::Quiet) out.reserve(2 * output_batch_size);
+    for (size_t i = start; i < end; i++) {
+        BasicBoard<N> b{ctx.solutions, i, ctx.patterns};
+        BasicSolver<N> s{ctx};
+        solve_guess(b, s, data, output, out);
+        if (out.size() >= output_batch_size) {
+            write_output(out);
+            out.clear();
+        }
+    }
+    // a quiet chunk of a parallel sweep has nothing to write
+    if (!out.empty()) write_output(out);
+    return data;
+}
+
+template <size_t N>
+GuessData solve_loop_parallel(const BasicSolverContext<N>& ctx, size_t start, size_t end, ThreadPool& pool,
+                              SweepProgress* progress) {
+    // one accumulator per worker, merged once everything is done so workers never contend on a lock
+    std::vector<GuessData> per_worker(pool.size());
+    pool.parallel_for(start, end, days_per_chunk, [&](size_t worker, size_t begin, size_t chunk_end) {
+        ProgressSlot* slot = progress ? &progress->slot(worker) : nullptr;
+        per_worker[worker].merge(solve_loop(ctx, begin, chunk_end, BoardOutput::Quiet, slot));
+    });
+    GuessData global_data{};
+    for (const auto& data : per_worker)
+        global_data.merge(data);
+    return global_data;
+}
+
+template <size_t N>
+GuessData solve_lockstep(const BasicSolverContext<N>& ctx, size_t start, size_t end, size_t width,
+                         ProgressSlot* progress) {
+    if (ctx.strategy || ctx.entropy) return solve_loop(ctx, start, end, BoardOutput::Quiet, progress);
+    // the games that got the same feedback to the same guesses share a state, and the solver picking its guess
+    struct Game {
+        BasicBoard<N> board;
+        size_t state = 0;
+        basic_pattern_t<N> feedback = 0;
+    };
+
+    GuessData data{};
+    data.progress = progress;
+    width = std::max<size_t>(width, 1);
+    std::vector<Game> games{};
+    // the games of the block still going, sorted by state instead of the games themselves, which are large
+    std::vector<uint32_t> playing{};
+    // by state, the states of this turn and of the next one. Only the states games are still in are kept, so the
+    // solvers of a block stay few enough to be in cache. They are large, a state keeping its solver only moves a pointer
+    std::vector<std::unique_ptr<BasicSolver<N>>> solvers{};
+    std::vector<std::unique_ptr<BasicSolver<N>>> next_solvers{};
+    next_solvers.reserve(std::min(width, end - start));
+    solvers.reserve(next_solvers.capacity());
+    for (size_t first = start; first < end; first += width) {
+        const auto window_start = std::chrono::steady_clock::now();
+        games.clear();
+        playing.clear();
+        for (size_t day = first; day < std::min(end, first + width); day++) {
+            playing.push_back(static_cast<uint32_t>(games.size()));
+            games.push_back({BasicBoard<N>{ctx.solutions, day, ctx.patterns}});
+        }
+        solvers.clear();
+        solvers.push_back(std::make_unique<BasicSolver<N>>(ctx));
+        while (!playing.empty()) {
+            // A state splits by the feedback its guess got, the games of every new state next to each other. The last
+            // new state of a state takes over its solver, the others start from a copy.
+            const auto key = [&](uint32_t g) { return std::pair{games[g].state, games[g].feedback}; };
+            std::ranges::sort(playing, {}, key);
+            next_solvers.clear();
+            for (auto it = playing.begin(); it != playing.end();) {
+                const auto group = key(*it);
+                const auto last = std::find_if(it, playing.end(), [&](uint32_t g) { return key(g) != group; });
+                if (last == playing.end() || games[*last].state != group.first) {
+                    next_solvers.push_back(std::move(solvers[group.first]));
+                } else {
+                    next_solvers.push_back(std::make_unique<BasicSolver<N>>(*solvers[group.first]));
+                }
+                const size_t next_state = next_solvers.size() - 1;
+                const guess_t guess = next_solvers[next_state]->next_guess(games[*it].board);
+                for (uint32_t g : std::span{it, last}) {
+                    auto& board = games[g].board;
+                    board.guess(guess);
+                    games[g].state = next_state;
+                    games[g].feedback = encode_pattern(board.board()[board.guesses() - 1]);
+                }
+                it = last;
+            }
+            std::swap(solvers, next_solvers);
+            std::erase_if(playing, [&](uint32_t g) {
+                const auto& board = games[g].board;
+                if (!board.solved() && board.guesses() < board.max_guesses()) return false;
+                data.latencies.push_back(std::chrono::steady_clock::now() - window_start);
+                data.add(board.guesses(), board.solved());
+                if (!board.solved()) data.failed_days.push_back(board.solution_index());
+                return true;
+            });
+        }
+    }
+    return data;
+}
+
+template <size_t N>
+GuessData solve_lockstep_parallel(const BasicSolverContext<N>& ctx, size_t start, size_t end, size_t width,
+                                  ThreadPool& pool, SweepProgress* progress) {
+    std::vector<GuessData> per_worker(pool.size());
+    pool.parallel_for(start, end, std::max<size_t>(width, 1), [&](size_t worker, size_t begin, size_t chunk_end) {
+        ProgressSlot* slot = progress ? &progress->slot(worker) : nullptr;
+        per_worker[worker].merge(solve_lockstep(ctx, begin, chunk_end, width, slot));
+    });
+    GuessData global_data{};
+    for (const auto& data : per_worker)
+        global_data.merge(data);
+    return global_data;
+}
+
+// A node of the strategy tree: the guess for one board state, computed once, and the solutions that reach this state
+// bucketed by the feedback they give to it.
+template <size_t N>
+struct TreeNode {
+    static constexpr size_t n_patterns = basic_pattern_count<N>;
+
+    guess_t guess;
+    BasicPartition<N> partition{};
+
+    TreeNode(const BasicSolverContext<N>& ctx, const BasicBoard<N>& board, BasicSolver<N>& solver,
+             std::span<const candidate_t> sols) :
+        guess(solver.next_guess(board)) {
+        partition.split(ctx.patterns, ctx.solutions, guess, sols);
+    }
+
+    std::span<const candidate_t> bucket(size_t pattern) const { return partition.bucket(pattern); }
+};
+
+// calls fn(board after the feedback, solutions giving it) for every feedback of the node that isn't the end of a game,
+// games that end here are added to out
+template <size_t N, typename F>
+void for_each_branch(const TreeNode<N>& node, const BasicBoard<N>& board, TreeData& out, F&& fn) {
+    for (size_t p = 0; p < TreeNode<N>::n_patterns; p++) {
+        auto group = node.bucket(p);
+        if (group.empty()) continue;
+        BasicBoard<N> child = board;
+        child.apply(node.guess, static_cast<basic_pattern_t<N>>(p));
+        if (child.solved() || child.guesses() == child.max_guesses()) {
+            out.games.add(child.guesses(), child.solved(), group.size());
+            if (!child.solved()) out.games.failed_days.insert(out.games.failed_days.end(), group.begin(), group.end());
+        } else {
+            fn(child, group);
+        }
+    }
+}
+
+template <size_t N>
+void solve_subtree(const BasicSolverContext<N>& ctx, const BasicBoard<N>& board, BasicSolver<N>& solver,
+                   std::span<const candidate_t> sols, TreeData& out) {
+    const TreeNode<N> node{ctx, board, solver, sols};
+    out.nodes++;
+    for_each_branch(node, board, out, [&](const BasicBoard<N>& child, std::span<const candidate_t> group) {
+        BasicSolver<N> child_solver = solver;
+        solve_subtree(ctx, child, child_solver, group, out);
+    });
+}
+
+template <size_t N>
+TreeData solve_tree(const BasicSolverContext<N>& ctx, size_t start, size_t end, ThreadPool* pool,
+                    SweepProgress* progress) {
+    TreeData data{};
+    if (start >= end) return data;
+    // the root is solved before the workers start, so it can share the first worker's slot
+    if (progress) data.games.progress = &progress->slot(0);
+    std::vector<candidate_t> days(end - start);
+    std::iota(days.begin(), days.end(), static_cast<candidate_t>(start));
+    BasicBoard<N> root{};
+    BasicSolver<N> solver{ctx};
+    const TreeNode<N> node{ctx, root, solver, days};
+    data.nodes++;
+    std::vector<std::pair<BasicBoard<N>, std::span<const candidate_t>>> branches{};
+    for_each_branch(node, root, data, [&](const BasicBoard<N>& child, std::span<const candidate_t> group) {
+        if (pool) {
+            branches.emplace_back(child, group);
+        } else {
+            BasicSolver<N> child_solver = solver;
+            solve_subtree(ctx, child, child_solver, group, data);
+        }
+    });
+    if (pool) {
+        std::vector<TreeData> per_worker(pool->size());
+        if (progress) {
+            for (size_t w = 0; w < per_worker.size(); w++)
+                per_worker[w].games.progress = &progress->slot(w);
+        }
+        pool->parallel_for(0, branches.size(), 1, [&](size_t worker, size_t begin, size_t branch_end) {
+            for (size_t i = begin; i < branch_end; i++) {
+                BasicSolver<N> child_solver = solver;
+                solve_subtree(ctx, branches[i].first, child_solver, branches[i].second, per_worker[worker]);
+            }
+        });
+        for (const auto& worker_data : per_worker)
+            data.merge(worker_data);
+    }
+    return data;
+}
+
+#define WS_INSTANTIATE_SWEEP(N)                                                                                        \
+    template bool solve_guess(BasicBoard<N>&, BasicSolver<N>&, GuessData&, BoardOutput, std::string&);                 \
+    template GuessData solve_loop(const BasicSolverContext<N>&, size_t, size_t, BoardOutput, ProgressSlot*);           \
+    template GuessData solve_loop_parallel(const BasicSolverContext<N>&, size_t, size_t, ThreadPool&,                  \
+                                           SweepProgress*);                                                            \
+    template GuessData solve_lockstep(const BasicSolverContext<N>&, size_t, size_t, size_t, ProgressSlot*);           \
+    template GuessData solve_lockstep_parallel(const BasicSolverContext<N>&, size_t, size_t, size_t, ThreadPool&,      \
+                                               SweepProgress*);                                                        \
+    template TreeData solve_tree(const BasicSolverContext<N>&, size_t, size_t, ThreadPool*, SweepProgress*);
+WS_FOR_EACH_WORD_SIZE(WS_INSTANTIATE_SWEEP)
@@ -0,0 +1,93 @@
+#pragma once
+#include "Progress.h"
+#include "Solver.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+// nearest rank percentile of a set of latencies, p in (0, 1]
+std::chrono::nanoseconds latency_percentile(std::span<const std::chrono::nanoseconds> latencies, double p);
+
+// Outcome of a set of games. Every worker fills its own and they are merged once the sweep is done, aligned so two
+// workers never write to the same cache line.
+struct alignas(64) GuessData {
+    size_t total_guesses = 0;
+    size_t guessed = 0;
+    size_t max_guesses = 0;
+    size_t min_guesses = std::numeric_limits<size_t>::max();
+    // games solved in 1, 2, ... guesses, as long as the longest solved game
+    std::vector<size_t> distribution{};
+    size_t failed = 0;
+    std::vector<size_t> failed_days{};
+    // wall time of every game played one by one, the tree sweep doesn't have any
+    std::vector<std::chrono::nanoseconds> latencies{};
+    // where the games are published as they finish, if anything follows the sweep. Not merged
+    ProgressSlot* progress = nullptr;
+
+    void add(size_t n_guesses, bool solved, size_t games = 1) {
+        if (progress) progress->add(games, solved);
+        total_guesses += n_guesses * games;
+        guessed += solved * games;
+        max_guesses = std::max(max_guesses, n_guesses);
+        min_guesses = std::min(min_guesses, n_guesses);
+        if (!solved) {
+            failed += games;
+            return;
+        }
+        if (distribution.size() < n_guesses) distribution.resize(n_guesses);
+        distribution[n_guesses - 1] += games;
+    }
+
+    void merge(const GuessData& other);
+    std::chrono::nanoseconds latency_percentile(double p) const { return ::latency_percentile(latencies, p); }
+};
+
+// days handed to a worker at a time, small enough that a few hard days don't leave the other threads idle at the end
+constexpr size_t days_per_chunk = 8;
+// games a lockstep sweep plays together, more share more states but spill out of the cache
+constexpr size_t lockstep_games = 256;
+// bytes of rendered games a sequential sweep collects before writing them out
+constexpr size_t output_batch_size = 64 * 1024;
+
+struct TreeData {
+    GuessData games{};
+    size_t nodes = 0;
+
+    void merge(const TreeData& other) {
+        games.merge(other.games);
+        nodes += other.nodes;
+    }
+};
+
+// the sweeps are instantiated for every word length, with the standard number of guesses
+// plays the game and renders it into out as the output mode says
+template <size_t N>
+bool solve_guess(BasicBoard<N>& b, BasicSolver<N>& s, GuessData& data, BoardOutput output, std::string& out);
+// With a progress the games are published to it as they finish, the parallel sweeps need one slot per worker.
+// The parallel sweeps are always quiet.
+template <size_t N>
+GuessData solve_loop(const BasicSolverContext<N>& ctx, size_t start, size_t end,
+                     BoardOutput output = BoardOutput::Full, ProgressSlot* progress = nullptr);
+template <size_t N>
+GuessData solve_loop_parallel(const BasicSolverContext<N>& ctx, size_t start, size_t end, ThreadPool& pool,
+                              SweepProgress* progress = nullptr);
+// Same results as solve_loop (quiet), but the days are played in blocks of width games advancing a turn at a time:
+// the games that got the same feedback to the same guesses so far pick their next guess once, with a single scan of
+// the dictionary. The latency of a game counts from the start of its block. The strategy and entropy engines are
+// played one game at a time. The parallel version hands out a block at a time.
+template <size_t N>
+GuessData solve_lockstep(const BasicSolverContext<N>& ctx, size_t start, size_t end, size_t width = lockstep_games,
+                         ProgressSlot* progress = nullptr);
+template <size_t N>
+GuessData solve_lockstep_parallel(const BasicSolverContext<N>& ctx, size_t start, size_t end, size_t width,
+                                  ThreadPool& pool, SweepProgress* progress = nullptr);
+// Same totals as solve_loop, but every distinct board state is solved once instead of once per day reaching it.
+// With a pool the subtrees below the first guess are spread over the workers.
+template <size_t N>
+TreeData solve_tree(const BasicSolverContext<N>& ctx, size_t start, size_t end, ThreadPool* pool,
+                    SweepProgress* progress = nullptr);
@@ -0,0 +1,122 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace std::chrono;
+
+ThreadPool::ThreadPool(size_t n_threads) :
+    m_workers(n_threads != 0 ? n_threads : std::max<size_t>(std::thread::hardware_concurrency(), 1)) {
+    m_threads.reserve(m_workers.size());
+    for (size_t i = 0; i < m_workers.size(); i++)
+        m_threads.emplace_back([this, i](std::stop_token stop) { work(stop, i); });
+}
+
+ThreadPool::~ThreadPool() {
+    // the stop requests wake up the waiting workers, jthread joins them
+    m_threads.clear();
+}
+
+bool ThreadPool::try_pop(size_t worker, Task& task, bool& stolen) {
+    {
+        auto& own = m_workers[worker];
+        std::scoped_lock lock{own.mutex};
+        if (!own.tasks.empty()) {
+            task = own.tasks.front();
+            own.tasks.pop_front();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            stolen = false;
+            return true;
+        }
+    }
+    for (size_t k = 1; k < m_workers.size(); k++) {
+        auto& victim = m_workers[(worker + k) % m_workers.size()];
+        std::scoped_lock lock{victim.mutex};
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            stolen = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::work(std::stop_token stop, size_t worker) {
+    while (!stop.stop_requested()) {
+        Task task{};
+        bool stolen = false;
+        if (!try_pop(worker, task, stolen)) {
+            std::unique_lock lock{m_sleep_mutex};
+            m_wake.wait(lock, stop, [this] { return m_queued.load(std::memory_order_relaxed) > 0; });
+            continue;
+        }
+        const auto start = steady_clock::now();
+        try {
+            task.job->run(task.job->fn, worker, task.begin, task.end);
+        } catch (...) {
+            std::scoped_lock lock{task.job->error_mutex};
+            if (!task.job->error) task.job->error = std::current_exception();
+        }
+        auto& stats = m_workers[worker].stats;
+        stats.chunks++;
+        stats.items += task.end - task.begin;
+        stats.stolen += stolen;
+        stats.busy += steady_clock::now() - start;
+        task.job->done.count_down();
+    }
+}
+
+void ThreadPool::run_job(Job& job, size_t start, size_t end, size_t chunk_size) {
+    if (start >= end) return;
+    const size_t n_chunks = (end - start + chunk_size - 1) / chunk_size;
+    // every worker starts with a contiguous run of chunks, stealing only kicks in once one runs out
+    const size_t per_worker = (n_chunks + m_workers.size() - 1) / m_workers.size();
+    m_queued.fetch_add(n_chunks, std::memory_order_relaxed);
+    for (size_t w = 0; w < m_workers.size(); w++) {
+        std::scoped_lock lock{m_workers[w].mutex};
+        for (size_t c = w * per_worker; c < std::min(n_chunks, (w + 1) * per_worker); c++)
+            m_workers[w].tasks.push_back(Task{&job, start + c * chunk_size, std::min(end, start + (c + 1) * chunk_size)});
+    }
+    {
+        // taking the lock orders the wake up after any worker that's about to sleep checked m_queued
+        std::scoped_lock lock{m_sleep_mutex};
+    }
+    m_wake.notify_all();
+    job.done.wait();
+    if (job.error) std::rethrow_exception(job.error);
+}
+
+std::vector<ThreadPool::WorkerStats> ThreadPool::stats() const {
+    std::vector<WorkerStats> result{};
+    result.reserve(m_workers.size());
+    for (const auto& worker : m_workers)
+        result.push_back(worker.stats);
+    return result;
+}
+
+void ThreadPool::reset_stats() {
+    for (auto& worker : m_workers)
+        worker.stats = {};
+}
+
+void ThreadPool::print_balance(std::ostream& out) const {
+    auto all = stats();
+    auto [min_items, max_items] =
+    std::ranges::minmax(all, {}, [](const WorkerStats& s) { return s.items; });
+    auto [min_busy, max_busy] = std::ranges::minmax(all, {}, [](const WorkerStats& s) { return s.busy; });
+    size_t chunks = 0;
+    size_t stolen = 0;
+    nanoseconds busy{};
+    for (const auto& s : all) {
+        chunks += s.chunks;
+        stolen += s.stolen;
+        busy += s.busy;
+    }
+    double mean_busy = static_cast<double>(busy.count()) / static_cast<double>(all.size());
+    out << "Work balance over " << all.size() << " workers: " << min_items.items << "-" << max_items.items
+        << " items each, busy " << duration_cast<milliseconds>(min_busy.busy) << "-"
+        << duration_cast<milliseconds>(max_busy.busy) << " (max/mean "
+        << (mean_busy > 0 ? static_cast<double>(max_busy.busy.count()) / mean_busy : 1.0) << "), " << stolen
+        << " of " << chunks << " chunks stolen\n";
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <iosfwd>
+#include <latch>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed set of workers with one task deque each. A worker takes its own tasks front to back and, once it runs out,
+// steals from the back of the other deques, so uneven chunks don't leave threads idle at the end of a job.
+class ThreadPool {
+    public:
+    struct WorkerStats {
+        size_t chunks = 0;
+        size_t items = 0;
+        size_t stolen = 0;
+        std::chrono::nanoseconds busy{};
+    };
+
+    private:
+    struct Job {
+        void (*run)(void* fn, size_t worker, size_t begin, size_t end);
+        void* fn;
+        std::latch done;
+        std::mutex error_mutex{};
+        std::exception_ptr error{};
+
+        Job(void (*run_)(void*, size_t, size_t, size_t), void* fn_, ptrdiff_t n_chunks) :
+            run(run_), fn(fn_), done(n_chunks) {}
+    };
+
+    struct Task {
+        Job* job;
+        size_t begin;
+        size_t end;
+    };
+
+    struct alignas(64) Worker {
+        std::mutex mutex{};
+        std::deque<Task> tasks{};
+        WorkerStats stats{};
+    };
+
+    std::vector<Worker> m_workers;
+    std::atomic<size_t> m_queued = 0;
+    std::mutex m_sleep_mutex{};
+    std::condition_variable_any m_wake{};
+    // last member so the workers are stopped and joined before anything they use is destroyed
+    std::vector<std::jthread> m_threads;
+
+    bool try_pop(size_t worker, Task& task, bool& stolen);
+    void work(std::stop_token stop, size_t worker);
+    void run_job(Job& job, size_t start, size_t end, size_t chunk_size);
+
+    public:
+    // 0 threads means one per hardware thread
+    explicit ThreadPool(size_t n_threads);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    size_t size() const noexcept { return m_workers.size(); }
+
+    // Calls fn(worker, begin, end) for consecutive chunks of at most chunk_size indices covering [start, end) and
+    // returns once all of them are done. worker is in [0, size()). Rethrows the first exception a chunk threw.
+    template <typename F>
+    void parallel_for(size_t start, size_t end, size_t chunk_size, F&& fn) {
+        auto run = [](void* f, size_t worker, size_t begin, size_t end_) {
+            (*static_cast<std::remove_reference_t<F>*>(f))(worker, begin, end_);
+        };
+        if (chunk_size == 0) chunk_size = 1;
+        Job job{run, &fn, static_cast<ptrdiff_t>(start < end ? (end - start + chunk_size - 1) / chunk_size : 0)};
+        run_job(job, start, end, chunk_size);
+    }
+
+    // stats accumulated since construction or the last reset
+    std::vector<WorkerStats> stats() const;
+    void reset_stats();
+    void print_balance(std::ostream& out) const;
+};
@@ -1,10 +1,22 @@
 #define DEBUG_PRINT 0
+#include "Adversary.h"
+#include "Batch.h"
+#include "EntropyScorer.h"
+#include "MultiBoard.h"
+#include "PatternMatrix.h"
+#include "Progress.h"
+#include "Server.h"
 #include "Solver.h"
+#include "StrategySearch.h"
+#include "Sweep.h"
+#include "ThreadPool.h"
+#include "data/WordListFile.h"
 #include <charconv>
 #include <chrono>
+#include <cstdio>
 #include <iostream>
 
-#include <mutex>
+#include <optional>
 #include <thread>
 
 using namespace std::string_view_literals;
@@ -18,47 +30,85 @@ There are 3 ways to invoke this program:
         2 - Two numbers divided by a hyphen (e.g. ".\WordleSolver.exe 1-20") this will make it attempt the wordles of days [begin, end)
 You can additionally add a -p before the number (still space separated, e.g. .\WordleSolver.exe -p 1-2309) to enable parallelization.
 A number can be additional added after -p (without space) to signal how many threads to spawn. 
-If no number is specified std::thread::max_concurrency() is used.
-It has no effect on single-solution program calls. Enabling parallelization won't print each result but just the final stats.
+If no number (or 0) is specified std::thread::hardware_concurrency() is used.
+Days are handed out to the threads in small chunks and idle threads steal chunks from busy ones.
+On single-solution program calls it sets the threads the entropy engine scores each turn on (all of them by default).
+Enabling parallelization won't print each result but just the final stats.
+Other options, to be put before the day(s):
+    --patterns[=file]  precompute the feedback of every dictionary word against every solution and look it up
+                       instead of computing it each guess. The table is cached in the given file
+                       (WordleSolver.patterns by default) and memory-mapped on later runs with the same word lists.
+    --pattern-memory=MiB
+                       memory the pattern table may take (1024 by default). A bigger table isn't cached: blocks of
+                       its rows are computed when needed and the least recently used ones dropped, or with room for
+                       less than 4 blocks every row is computed whenever it's needed.
+    --strategy=name    how the next guess is picked:
+                           heuristic (default)  the best rated word that fits everything known so far
+                           entropy              the word whose feedback splits the remaining solutions the most,
+                                                implies --patterns
+                           optimal              follow the strategy tree with the fewest guesses in total found by
+                                                an offline search over the solutions, implies --patterns. The tree
+                                                is cached in WordleSolver.strategy, the search runs on all threads
+                                                (or as many as -p says) when the cache is missing or stale, and
+                                                reports how the heuristic strategy compares.
+    --search-width=N   probes the search tries at every board state, the ones splitting the remaining solutions into
+                       the most groups first (default 8). 0 tries every word and finds the optimal tree, in hours.
+    --worst-case       the search minimizes the guesses of the longest game first, then the total
+    --hard             hard mode: every guess uses all the hints so far, greens in their spot and yellows anywhere.
+                       Applies to every strategy and to the batch and daemon requests.
+    --progress[=s]     while a range of days is played, print the games done, games/s, success rate and ETA to
+                       stderr every s seconds (10 by default)
+    --output=mode      what a range of days played without -p prints of every game:
+                           full (default)  the colored board and the solution
+                           compact         a line per game: "<word> <guesses or X>/6 <colored guesses>..."
+                           quiet           nothing, only the final stats
+    --tree             play a range of days as one strategy tree: days sharing the same feedback so far share the
+                       work for their next guess. Same results, no per-day output.
+    --lockstep[=N]     play a range of days in blocks of N games (256 by default) advancing a turn at a time, the
+                       games sharing the same feedback so far pick their next guess once. Same results, no per-day
+                       output, the latency of a game counts from the start of its block. No --tree.
+    --batch            instead of days, read requests from stdin, one per line: a day or a solution word, optionally
+                       followed by a strategy (e.g. "cigar entropy"). Writes one line per request to stdout, in order:
+                       "<day> <word> <guesses or X> <guess>...", or "error <reason>". Requests are played in batches
+                       of a few thousand on all threads (or as many as -p says), so it's meant for piping.
+    --dict=file        use the words in the file (one per line) as the dictionary instead of the built-in one
+    --solutions=file   use the words in the file (one per line) as the solutions, the first one is day 0.
+                       Both lists have to have words of the same length, from 4 to 8 letters. Words other than
+                       5 letters work with the heuristic strategy only, without --patterns, --batch and the daemon.
+    --serve[=socket]   run as a daemon on a Unix domain socket (WordleSolver.sock by default), Linux only.
+                       Every connection is a session that plays games interactively:
+                           new [heuristic|entropy]  start a game, the answer is "guess <word>"
+                           feedback <digits>        one digit per letter, 0 grey, 1 yellow, 2 green. The answer is
+                                                    "guess <word>", "solved <guesses>" or "lost"
+                           quit                     end the session
+                       Requests are solved on all threads (or as many as -p says). Stops on Ctrl+C.
+    --boards=N         play N boards at once (2 for Dordle, 4 for Quordle, 8 for Octordle, up to 16) with every guess
+                       going to all of them, within N + 5 guesses. The game of day d has the solutions of days d to
+                       d + N - 1 on its boards. Heuristic strategy only, no --tree, --lockstep or --hard.
+    --absurdle         play a single game against an adversarial host instead of days: it has no solution up front
+                       and answers every guess with the feedback that keeps the most solutions possible (ties go to
+                       the feedback giving away the least). Works with every strategy and --hard.
+    --connect[=socket] play the days against a running daemon instead of solving them here, over as many sessions
+                       as -p says (1 without -p). Reports the results and the latency of every request.
 )"sv;
 
-struct GuessData {
-    size_t total_guesses = 0;
-    size_t guessed = 0;
-    size_t max_guesses = 0;
-    size_t min_guesses = std::numeric_limits<size_t>::max();
-};
+constexpr auto default_pattern_cache = "WordleSolver.patterns"sv;
+constexpr auto default_progress_interval = 10s;
+constexpr auto default_socket = "WordleSolver.sock"sv;
+constexpr auto default_strategy_file = "WordleSolver.strategy"sv;
 
 struct RAIIPerfTimer {
     const high_resolution_clock::time_point start;
-    RAIIPerfTimer() : start(high_resolution_clock::now()) {}
+    std::ostream& out;
+    RAIIPerfTimer(std::ostream& out_ = std::cout) : start(high_resolution_clock::now()), out(out_) {}
     ~RAIIPerfTimer() { 
         auto elapsed = (high_resolution_clock::now() - start);
-        std::cout << "Elapsed " << duration_cast<milliseconds>(elapsed) << " (" << elapsed << ")\n"; 
+        out << "Elapsed " << duration_cast<milliseconds>(elapsed) << " (" << elapsed << ")\n"; 
     }
 };
 
-bool solve_guess(Board& b, Solver& s, GuessData& data, bool print_intermediate) {
-    while (!b.solved() && b.guesses() < b.max_guesses()) {
-        b.guess(s.next_guess(b));
-    }
-    if (print_intermediate) b.print(s);
-    size_t n_guesses = b.guesses();
-    bool solved = b.solved();
-    data.total_guesses += n_guesses;
-    if (solved) {
-        data.guessed++;
-        if (print_intermediate)
-            std::cout << "Solved in " << b.guesses() << " guesse(s), the word was " << b.solution() << "\n\n";
-    } else {
-        if (print_intermediate) std::cout << "Didn't solve it, the word was " << b.solution() << "\n\n";
-    }
-    data.max_guesses = std::max(data.max_guesses, n_guesses);
-    data.min_guesses = std::min(data.min_guesses, n_guesses);
-    return solved;
-}
-
-bool solve_guess(Board& b, Solver& s) {
+template <size_t N>
+bool solve_guess(BasicBoard<N>& b, BasicSolver<N>& s) {
     while (!b.solved() && b.guesses() < b.max_guesses()) {
         b.guess(s.next_guess(b));
     }
@@ -73,50 +123,60 @@ bool solve_guess(Board& b, Solver& s) {
     return solved;
 }
 
-GuessData solve_loop(const std::span<std::string_view>& solutions, const std::span<WordView>& dict, size_t start,
-                     size_t end, bool parallel = false) {
-    GuessData data{};
-    for (size_t i = start; i < end; i++) {
-        Board b{solutions, i};
-        Solver s{dict};
-        solve_guess(b, s, data, !parallel);
-    }
-    return data;
-}
+struct ProgramOptions {
+    std::string_view days{};
+    bool parallel = false;
+    size_t n_threads = std::thread::hardware_concurrency();
+    std::optional<std::string_view> pattern_cache{};
+    size_t pattern_budget = default_pattern_budget;
+    Strategy strategy = Strategy::Heuristic;
+    bool tree = false;
+    // games per block of a lockstep sweep, 0 plays them one at a time
+    size_t lockstep = 0;
+    bool batch = false;
+    std::optional<std::string_view> serve{};
+    std::optional<std::string_view> connect{};
+    std::optional<std::string_view> dict_file{};
+    std::optional<std::string_view> solutions_file{};
+    // 1 for the standard game, more for the multi-board mode
+    size_t boards = 1;
+    bool hard = false;
+    bool absurdle = false;
+    size_t search_width = default_search_width;
+    bool worst_case = false;
+    // 0 doesn't report
+    seconds progress_interval{0};
+    BoardOutput output = BoardOutput::Full;
+};
 
-GuessData solve_loop_parallel(const std::span<std::string_view>& solutions, const std::span<WordView>& dict,
-                              size_t start, size_t end, size_t n_threads) {
-    size_t n_problems_per_thread = (end - start) / n_threads;
-    size_t rest = (end - start) % n_threads;
-    std::vector<std::jthread> threads{};
-    std::mutex m{};
-    GuessData global_data{};
-    threads.reserve(n_threads);
-    for (size_t i = 0; i < n_threads; i++) {
-        size_t t_start = start + (i * n_problems_per_thread);
-        size_t t_end = end - ((n_threads - i - 1) * n_problems_per_thread) - (rest * (i != n_threads - 1));
-        threads.emplace_back([&solutions, &dict, &m, &global_data, t_start, t_end]() {
-            auto data = solve_loop(solutions, dict, t_start, t_end, true);
-            {
-                std::scoped_lock lock{m};
-                global_data.total_guesses += data.total_guesses;
-                global_data.guessed += data.guessed;
-                global_data.max_guesses = std::max(global_data.max_guesses, data.max_guesses);
-                global_data.min_guesses = std::min(global_data.min_guesses, data.min_guesses);
-            }
-        });
-    }
-    // .clear() calls the dtor of the vector elements one-by-one
-    // since jthread join on destruction this is equal to calling .join on each thread
-    threads.clear();
-    return global_data;
+void print_latency(std::string_view label, std::span<const nanoseconds> latencies) {
+    if (latencies.empty()) return;
+    auto us = [&](double p) { return duration_cast<microseconds>(latency_percentile(latencies, p)); };
+    std::cout << label << ": p50 " << us(0.5) << ", p90 " << us(0.9) << ", p99 " << us(0.99) << ", max " << us(1.0)
+              << '\n';
 }
 
-void print_result(const GuessData& data, size_t sample_size) {
+// the distribution goes up to guess_limit even if no game took that many guesses
+void print_result(const GuessData& data, size_t sample_size, std::span<const std::string_view> solutions,
+                  size_t guess_limit = Board::max_guesses()) {
     std::cout << "Correctly guessed " << data.guessed << " out of " << sample_size << '\n';
     std::cout << "Max guesses " << data.max_guesses << ", Min guesses " << data.min_guesses << '\n';
     std::cout << "Average guesses: " << (static_cast<double>(data.total_guesses) / static_cast<double>(sample_size))
               << '\n';
+    std::cout << "Guess distribution:";
+    for (size_t i = 0; i < std::max(guess_limit, data.distribution.size()); i++)
+        std::cout << ' ' << i + 1 << ": " << (i < data.distribution.size() ? data.distribution[i] : 0) << ',';
+    std::cout << " failed: " << data.failed << '\n';
+    if (!data.failed_days.empty()) {
+        // the workers finish in any order
+        auto failed = data.failed_days;
+        std::ranges::sort(failed);
+        std::cout << "Failed days:";
+        for (size_t i = 0; i < failed.size(); i++)
+            std::cout << (i % 10 == 0 ? "\n    " : " ") << failed[i] << " (" << solutions[failed[i]] << ')';
+        std::cout << '\n';
+    }
+    print_latency("Solve latency", data.latencies);
 }
 
 int invalid_argument(std::string_view arg) {
@@ -125,43 +185,289 @@ int invalid_argument(std::string_view arg) {
     return EXIT_FAILURE;
 }
 
-int main(int argc, char** argv) {
-    const auto& solutions = get_solutions();
-    const auto& dict = get_dictionary();
+// returns the offending argument if the arguments are malformed
+std::optional<std::string_view> parse_options(int argc, char** argv, ProgramOptions& opts) {
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg{argv[i]};
+        if (arg.starts_with("--"sv)) {
+            std::string_view name = arg.substr(0, arg.find('='));
+            std::optional<std::string_view> value{};
+            if (name.size() < arg.size()) value = arg.substr(name.size() + 1);
+            if (name == "--patterns"sv) {
+                opts.pattern_cache = value.value_or(default_pattern_cache);
+            } else if (name == "--pattern-memory"sv && value.has_value()) {
+                size_t mib = 0;
+                auto res = std::from_chars(value->data(), value->data() + value->size(), mib);
+                if (res.ec != std::errc{} || res.ptr != value->data() + value->size() || mib > SIZE_MAX >> 20)
+                    return arg;
+                opts.pattern_budget = mib << 20;
+            } else if (name == "--progress"sv) {
+                size_t interval = default_progress_interval.count();
+                if (value.has_value()) {
+                    auto res = std::from_chars(value->data(), value->data() + value->size(), interval);
+                    if (res.ec != std::errc{} || res.ptr != value->data() + value->size() || interval == 0) return arg;
+                }
+                opts.progress_interval = seconds{interval};
+            } else if (name == "--output"sv && value == "full"sv) {
+                opts.output = BoardOutput::Full;
+            } else if (name == "--output"sv && value == "compact"sv) {
+                opts.output = BoardOutput::Compact;
+            } else if (name == "--output"sv && value == "quiet"sv) {
+                opts.output = BoardOutput::Quiet;
+            } else if (name == "--tree"sv && !value.has_value()) {
+                opts.tree = true;
+            } else if (name == "--lockstep"sv) {
+                opts.lockstep = lockstep_games;
+                if (value.has_value()) {
+                    auto res = std::from_chars(value->data(), value->data() + value->size(), opts.lockstep);
+                    if (res.ec != std::errc{} || res.ptr != value->data() + value->size() || opts.lockstep == 0)
+                        return arg;
+                }
+            } else if (name == "--hard"sv && !value.has_value()) {
+                opts.hard = true;
+            } else if (name == "--absurdle"sv && !value.has_value()) {
+                opts.absurdle = true;
+            } else if (name == "--batch"sv && !value.has_value()) {
+                opts.batch = true;
+            } else if (name == "--dict"sv && value.has_value()) {
+                opts.dict_file = value;
+            } else if (name == "--solutions"sv && value.has_value()) {
+                opts.solutions_file = value;
+            } else if (name == "--boards"sv && value.has_value()) {
+                auto res = std::from_chars(value->data(), value->data() + value->size(), opts.boards);
+                if (res.ec != std::errc{} || opts.boards < min_boards || opts.boards > max_boards) return arg;
+            } else if (name == "--serve"sv) {
+                opts.serve = value.value_or(default_socket);
+            } else if (name == "--connect"sv) {
+                opts.connect = value.value_or(default_socket);
+            } else if (name == "--strategy"sv && value == "heuristic"sv) {
+                opts.strategy = Strategy::Heuristic;
+            } else if (name == "--strategy"sv && value == "entropy"sv) {
+                opts.strategy = Strategy::Entropy;
+                if (!opts.pattern_cache.has_value()) opts.pattern_cache = default_pattern_cache;
+            } else if (name == "--strategy"sv && value == "optimal"sv) {
+                opts.strategy = Strategy::Optimal;
+                if (!opts.pattern_cache.has_value()) opts.pattern_cache = default_pattern_cache;
+            } else if (name == "--search-width"sv && value.has_value()) {
+                auto res = std::from_chars(value->data(), value->data() + value->size(), opts.search_width);
+                if (res.ec != std::errc{}) return arg;
+            } else if (name == "--worst-case"sv && !value.has_value()) {
+                opts.worst_case = true;
+            } else {
+                return arg;
+            }
+        } else if (constexpr auto arg_cmp = "-p"sv; arg.starts_with(arg_cmp)) {
+            opts.parallel = true;
+            if (arg.size() > arg_cmp.size()) {
+                auto resp = std::from_chars(arg.data() + arg_cmp.size(), arg.data() + arg.size(), opts.n_threads);
+                if (resp.ec != std::errc{}) { return arg; }
+            }
+        } else if (opts.days.empty()) {
+            opts.days = arg;
+        } else {
+            return arg;
+        }
+    }
+    return std::nullopt;
+}
+
+// everything after loading the word lists, for words of N letters
+template <size_t N>
+int run(const ProgramOptions& opts, std::span<const std::string_view> solutions, std::span<const WordView> dict) {
+    // the pattern table is one byte per feedback, the daemon and batch protocols are fixed to the standard length
+    if (N != PatternMatrix::word_size && (opts.pattern_cache || opts.batch || opts.serve || opts.connect)) {
+        std::cerr << "--patterns, --strategy=entropy, --batch, --serve and --connect need words of "
+                  << PatternMatrix::word_size << " letters, the word lists have " << N << '\n';
+        return EXIT_FAILURE;
+    }
     constexpr auto first_day = sys_days{2021y / June / 19};
     auto sol_idx_point = time_point{system_clock::now()} - time_point{first_day};
-    size_t sol_idx = duration_cast<days>(sol_idx_point).count() + 1ull;
+    size_t sol_idx = std::min<size_t>(duration_cast<days>(sol_idx_point).count() + 1ull, solutions.size());
     auto all_days = std::format("1-{}", solutions.size());
-    if (argc < 2) {
-        RAIIPerfTimer timer{};
-        auto data = solve_loop(solutions, dict, 0, sol_idx);
-        print_result(data, sol_idx);
-    } else {
-        std::string_view arg{argv[argc - 1]};
-        bool parallel = false;
-        size_t n_threads = std::thread::hardware_concurrency();
-        if (argc == 3) {
-            std::string_view parallel_arg{argv[argc - 2]};
-            constexpr auto arg_cmp = "-p"sv;
-            constexpr size_t arg_size = arg_cmp.size();
-            if (parallel_arg.starts_with(arg_cmp)) {
-                parallel = true;
-                if (parallel_arg.size() > arg_size) {
-                    auto resp = std::from_chars(parallel_arg.data() + arg_size,
-                                                parallel_arg.data() + parallel_arg.size(), n_threads);
-                    if (resp.ec != std::errc{}) { return invalid_argument(parallel_arg); }
-                }
-            } else {
-                return invalid_argument(parallel_arg);
+    if ((opts.batch || opts.serve) && !opts.days.empty()) { return invalid_argument(opts.days); }
+    if (opts.batch + opts.serve.has_value() + opts.connect.has_value() > 1) { return invalid_argument("--batch"sv); }
+    if (opts.tree && opts.lockstep > 0) { return invalid_argument("--lockstep"sv); }
+    // the sweeps sharing the guesses of games are for the standard game
+    const bool shared_sweep = opts.tree || opts.lockstep > 0;
+    const bool multi_incompatible = shared_sweep || opts.batch || opts.serve || opts.connect || opts.hard;
+    if (opts.boards > 1 && (multi_incompatible || opts.strategy != Strategy::Heuristic)) {
+        return invalid_argument("--boards"sv);
+    }
+    const bool absurdle_incompatible = shared_sweep || opts.batch || opts.serve || opts.connect || opts.boards > 1;
+    if (opts.absurdle && (absurdle_incompatible || !opts.days.empty())) {
+        return invalid_argument("--absurdle"sv);
+    }
+    // the tree is built for the standard game, it doesn't follow the hard mode hints
+    if (opts.strategy == Strategy::Optimal && (opts.batch || opts.serve || opts.connect || opts.hard)) {
+        return invalid_argument("--strategy=optimal"sv);
+    }
+    // batch mode keeps stdout for the results
+    std::ostream& log = opts.batch ? std::cerr : std::cout;
+    // every mode ends with the counters when they're compiled in, whichever way it returns. Declared before the pools
+    // so their workers are done counting
+    struct StatsReport {
+        std::ostream& out;
+        ~StatsReport() {
+            if constexpr (solver_stats::enabled) solver_stats::print_report(out);
+        }
+    } stats_report{log};
+    std::optional<PatternMatrix> pattern_matrix{};
+    auto load_patterns = [&](std::string_view cache) {
+        RAIIPerfTimer timer{log};
+        pattern_matrix = PatternMatrix::load_or_build(dict, solutions, cache, opts.pattern_budget);
+        const auto size = std::format("{}x{}", pattern_matrix->rows(), pattern_matrix->cols());
+        switch (pattern_matrix->storage()) {
+        case PatternStorage::Full:
+            log << (pattern_matrix->mapped() ? "Mapped" : "Built") << " the " << size << " pattern table, ";
+            break;
+        case PatternStorage::Tiled:
+            log << "Tiling the " << size << " pattern table in " << pattern_matrix->tile_stats().capacity
+                << " blocks of " << PatternMatrix::tile_rows << " rows, ";
+            break;
+        case PatternStorage::OnTheFly:
+            log << "Computing the " << size << " pattern table on the fly, ";
+            break;
+        }
+    };
+    // a client only gives feedback, the daemon does the solving
+    if (opts.pattern_cache.has_value() && !opts.connect) load_patterns(*opts.pattern_cache);
+    // a single game has no days to spread over the threads, the entropy engine scores the probes of every turn on
+    // them instead
+    const bool single_game = opts.absurdle || (!opts.days.empty() && opts.days.find('-') == std::string_view::npos);
+    std::optional<ThreadPool> scoring_pool{};
+    if (opts.strategy == Strategy::Entropy && single_game && !opts.connect) scoring_pool.emplace(opts.n_threads);
+    std::optional<EntropyScorer> entropy{};
+    if (opts.strategy == Strategy::Entropy && !opts.connect)
+        entropy.emplace(*pattern_matrix, dict, solutions, scoring_pool ? &*scoring_pool : nullptr);
+    const BasicPackedDictionary<N> packed{dict};
+    const BasicCandidateIndex<N> index{packed};
+    BasicSolverContext<N> ctx{solutions, dict, &packed, &index, pattern_matrix ? &*pattern_matrix : nullptr,
+                              entropy ? &*entropy : nullptr, opts.hard};
+
+    if constexpr (N == PatternMatrix::word_size) {
+        // batch and daemon requests pick their strategy, the entropy engine is only set up once one asks for it
+        SolverContext heuristic_ctx = ctx;
+        heuristic_ctx.entropy = nullptr;
+        std::optional<SolverContext> entropy_ctx{};
+        if (entropy) entropy_ctx = ctx;
+        auto context = [&](Strategy strategy) -> const SolverContext& {
+            if (strategy == Strategy::Heuristic) return heuristic_ctx;
+            if (!entropy_ctx) {
+                if (!pattern_matrix) load_patterns(default_pattern_cache);
+                entropy.emplace(*pattern_matrix, dict, solutions);
+                entropy_ctx = SolverContext{solutions, dict, &packed, &index, &*pattern_matrix, &*entropy, opts.hard};
+            }
+            return *entropy_ctx;
+        };
+        if (opts.serve) {
+            std::cout << "Serving on " << *opts.serve << std::endl;
+            try {
+                run_server(*opts.serve, opts.n_threads, opts.strategy, context);
+            } catch (const std::runtime_error& e) {
+                std::cerr << "The daemon stopped: " << e.what() << '\n';
+                return EXIT_FAILURE;
             }
-        } else if (argc == 2 && arg == "-p") {
-            parallel = true;
-            arg = all_days;
+            return EXIT_SUCCESS;
         }
-        if (arg == "help"sv) {
-            std::cout << help_message << '\n';
+        if (opts.batch) {
+            ThreadPool batch_pool{opts.n_threads};
+            BatchStats stats{};
+            {
+                RAIIPerfTimer timer{log};
+                stats = run_batch(stdin, stdout, batch_pool, opts.strategy, context);
+                log << "Batch: " << stats.requests << " requests, " << stats.errors << " errors, ";
+            }
             return EXIT_SUCCESS;
         }
+    }
+
+    std::optional<StrategyTree> strategy_tree{};
+    if constexpr (N == PatternMatrix::word_size) {
+        if (opts.strategy == Strategy::Optimal) {
+            const StrategyTree::Key key{PatternMatrix::dictionary_hash(dict, solutions),
+                                        static_cast<uint32_t>(opts.search_width), opts.worst_case};
+            strategy_tree = StrategyTree::load(default_strategy_file, key, dict.size());
+            if (strategy_tree->empty()) {
+                ThreadPool search_pool{opts.n_threads};
+                SearchReport report{};
+                strategy_tree = search_strategy(ctx, {opts.search_width, opts.worst_case}, search_pool, report);
+                const auto games = static_cast<double>(solutions.size());
+                std::cout << "Strategy search: " << report.total_guesses << " guesses in total ("
+                          << static_cast<double>(report.total_guesses) / games << " per game), at most "
+                          << report.max_guesses << ", " << report.states << " states searched, "
+                          << report.table_entries << " in the table, "
+                          << duration_cast<milliseconds>(report.elapsed) << '\n';
+                // the gap to the heuristic engine on the same solutions, lost games count all their guesses
+                const GuessData heuristic = solve_loop_parallel(ctx, 0, solutions.size(), search_pool);
+                std::cout << "Heuristic strategy: " << heuristic.total_guesses << " guesses in total ("
+                          << static_cast<double>(heuristic.total_guesses) / games << " per game), "
+                          << heuristic.failed << " lost\n";
+                if (!strategy_tree->save(default_strategy_file, key))
+                    std::cerr << "Couldn't write the strategy tree " << default_strategy_file << ", continuing\n";
+            }
+            ctx.strategy = &*strategy_tree;
+        }
+    }
+
+    if (opts.absurdle) {
+        GuessData data{};
+        RAIIPerfTimer timer{};
+        solve_adversarial_game(ctx, data, true);
+        return EXIT_SUCCESS;
+    }
+
+    std::optional<ThreadPool> pool{};
+    if (opts.parallel && !opts.connect) pool.emplace(opts.n_threads);
+
+    auto sweep = [&](size_t start_idx, size_t end_idx) {
+        const auto start = steady_clock::now();
+        {
+            RAIIPerfTimer timer{};
+            // reports on stderr while the games are played, stopped before the results are printed
+            std::optional<SweepProgress> progress{};
+            std::optional<ProgressReporter> reporter{};
+            if (opts.progress_interval.count() > 0 && !opts.connect) {
+                progress.emplace(pool ? pool->size() : 1, end_idx - start_idx);
+                reporter.emplace(*progress, opts.progress_interval, std::cerr);
+            }
+            SweepProgress* tracked = progress ? &*progress : nullptr;
+            ProgressSlot* slot = progress ? &progress->slot(0) : nullptr;
+            if (opts.connect) {
+                auto result = run_client(*opts.connect, solutions, start_idx, end_idx,
+                                         opts.parallel ? opts.n_threads : 1, opts.strategy);
+                print_result(result.games, end_idx - start_idx, solutions);
+                print_latency("Request latency", result.turn_latencies);
+            } else if (opts.boards > 1) {
+                auto data = pool ? solve_multi_loop_parallel(ctx, opts.boards, start_idx, end_idx, *pool, tracked)
+                                 : solve_multi_loop(ctx, opts.boards, start_idx, end_idx, opts.output, slot);
+                reporter.reset();
+                print_result(data, end_idx - start_idx, solutions, multi_guess_budget(opts.boards));
+            } else if (opts.tree) {
+                auto data = solve_tree(ctx, start_idx, end_idx, pool ? &*pool : nullptr, tracked);
+                reporter.reset();
+                print_result(data.games, end_idx - start_idx, solutions);
+                std::cout << "Strategy tree: " << data.nodes << " nodes for " << data.games.total_guesses
+                          << " guesses\n";
+            } else if (opts.lockstep > 0) {
+                auto data = pool ? solve_lockstep_parallel(ctx, start_idx, end_idx, opts.lockstep, *pool, tracked)
+                                 : solve_lockstep(ctx, start_idx, end_idx, opts.lockstep, slot);
+                reporter.reset();
+                print_result(data, end_idx - start_idx, solutions);
+            } else {
+                auto data = pool ? solve_loop_parallel(ctx, start_idx, end_idx, *pool, tracked)
+                                 : solve_loop(ctx, start_idx, end_idx, opts.output, slot);
+                reporter.reset();
+                print_result(data, end_idx - start_idx, solutions);
+            }
+        }
+        if (pool) pool->print_balance(std::cout);
+        if (entropy) entropy->print_stats(end_idx - start_idx, steady_clock::now() - start);
+        if (pattern_matrix) pattern_matrix->print_stats(std::cout);
+    };
+    if (opts.days.empty() && !opts.parallel) {
+        sweep(0, sol_idx);
+    } else {
+        std::string_view arg = opts.days.empty() ? std::string_view{all_days} : opts.days;
         if (size_t idx = arg.find('-'); idx != std::string_view::npos) {
             size_t start_idx = 0;
             size_t end_idx = 0;
@@ -171,22 +477,83 @@ int main(int argc, char** argv) {
             auto res2 = std::from_chars(end.data(), end.data() + end.size(), end_idx);
             if (res1.ec != std::errc{} || res2.ec != std::errc{}) { return invalid_argument(arg); }
             if (start_idx > end_idx) std::swap(start_idx, end_idx);
-            RAIIPerfTimer timer{};
-            if (!parallel) {
-                auto data = solve_loop(solutions, dict, start_idx, end_idx);
-                print_result(data, end_idx - start_idx);
-            } else {
-                auto data = solve_loop_parallel(solutions, dict, start_idx, end_idx, n_threads);
-                print_result(data, end_idx - start_idx);
-            }
+            end_idx = std::min(end_idx, solutions.size());
+            start_idx = std::min(start_idx, end_idx);
+            sweep(start_idx, end_idx);
         } else {
             idx = 0;
             auto res1 = std::from_chars(arg.data(), arg.data() + arg.size(), idx);
-            if (res1.ec != std::errc{}) { return invalid_argument(arg); }
-            Board b{solutions, idx};
-            Solver s{dict};
+            if (res1.ec != std::errc{} || idx >= solutions.size()) { return invalid_argument(arg); }
+            if (opts.connect) {
+                sweep(idx, idx + 1);
+                return EXIT_SUCCESS;
+            }
+            if (opts.boards > 1) {
+                GuessData data{};
+                std::string out{};
+                solve_multi_game(ctx, opts.boards, idx, data, BoardOutput::Full, out);
+                write_output(out);
+                return EXIT_SUCCESS;
+            }
+            BasicBoard<N> b{ctx.solutions, idx, ctx.patterns};
+            BasicSolver<N> s{ctx};
             solve_guess(b, s);
         }
     }
     return EXIT_SUCCESS;
 }
+
+// instantiates run for every word length the engine is compiled for and calls the one for n
+template <size_t N = min_word_size>
+int run_for_word_size(size_t n, const ProgramOptions& opts, std::span<const std::string_view> solutions,
+                      std::span<const WordView> dict) {
+    if constexpr (N > max_word_size) {
+        std::cerr << "Words of " << n << " letters aren't supported, the solver handles " << min_word_size << " to "
+                  << max_word_size << '\n';
+        return EXIT_FAILURE;
+    } else {
+        return n == N ? run<N>(opts, solutions, dict) : run_for_word_size<N + 1>(n, opts, solutions, dict);
+    }
+}
+
+int main(int argc, char** argv) {
+    ProgramOptions opts{};
+    if (auto bad_arg = parse_options(argc, argv, opts); bad_arg.has_value()) { return invalid_argument(*bad_arg); }
+    if (opts.days == "help"sv) {
+        std::cout << help_message << '\n';
+        return EXIT_SUCCESS;
+    }
+    // the views of custom lists point into the mapped files, which stay mapped until the end
+    std::optional<WordListFile> solutions_file{};
+    std::optional<WordListFile> dict_file{};
+    std::vector<WordView> custom_dict{};
+    std::span<const std::string_view> solutions{};
+    std::span<const WordView> dict{};
+    try {
+        solutions = opts.solutions_file ? solutions_file.emplace(*opts.solutions_file).words() : get_solutions();
+        if (opts.dict_file) {
+            custom_dict = make_dictionary(dict_file.emplace(*opts.dict_file).words());
+            dict = custom_dict;
+        } else {
+            dict = get_dictionary();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to load the word lists: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    // every list has words of a single length, checked when it's loaded
+    const size_t word_size = dict.front().word.size();
+    if (solutions.front().size() != word_size) {
+        std::cerr << "The dictionary has words of " << word_size << " letters but the solutions have "
+                  << solutions.front().size() << '\n';
+        return EXIT_FAILURE;
+    }
+    // a solution the dictionary doesn't have can never be guessed
+    try {
+        PatternMatrix::solution_rows(dict, solutions);
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    return run_for_word_size(word_size, opts, solutions, dict);
+}
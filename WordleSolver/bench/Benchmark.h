@@ -0,0 +1,102 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bench {
+    // keeps the optimizer from dropping a computation whose result is otherwise unused
+    template <typename T>
+    void keep(const T& value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        static const volatile void* sink;
+        sink = &value;
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    }
+
+    struct Options {
+        size_t warmup = 2;
+        size_t repetitions = 30;
+        std::string_view filter{};
+    };
+
+    struct Result {
+        std::string name;
+        // what an item is, e.g. "words" or "games"
+        std::string unit;
+        double items_per_op;
+        std::vector<double> samples_ns;
+
+        double percentile(double p) const {
+            auto sorted = samples_ns;
+            std::ranges::sort(sorted);
+            // nearest rank
+            size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+            return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+        }
+        double median() const { return percentile(0.5); }
+    };
+
+    class Suite {
+        Options m_opts;
+        std::vector<Result> m_results{};
+
+        public:
+        explicit Suite(Options opts) : m_opts(opts) {}
+
+        bool enabled(std::string_view name) const { return name.find(m_opts.filter) != std::string_view::npos; }
+
+        // Times op() after a few warmup calls, setup() runs untimed before every call. One call of op covers
+        // items_per_op items. repetitions overrides the suite default for slow benchmarks.
+        template <typename Setup, typename Op>
+        void run(std::string name, std::string unit, double items_per_op, Setup&& setup, Op&& op,
+                 size_t repetitions = 0) {
+            if (!enabled(name)) return;
+            if (repetitions == 0) repetitions = m_opts.repetitions;
+            for (size_t i = 0; i < m_opts.warmup; i++) {
+                setup();
+                op();
+            }
+            Result result{std::move(name), std::move(unit), items_per_op, {}};
+            result.samples_ns.reserve(repetitions);
+            for (size_t i = 0; i < repetitions; i++) {
+                setup();
+                auto start = std::chrono::steady_clock::now();
+                op();
+                std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+                result.samples_ns.push_back(elapsed.count());
+            }
+            m_results.push_back(std::move(result));
+        }
+
+        template <typename Op>
+        void run(std::string name, std::string unit, double items_per_op, Op&& op, size_t repetitions = 0) {
+            run(std::move(name), std::move(unit), items_per_op, [] {}, std::forward<Op>(op), repetitions);
+        }
+
+        // for measurements that can only be taken once per process, like a first call
+        void record(std::string name, std::string unit, double items_per_op, std::vector<double> samples_ns) {
+            if (!enabled(name) || samples_ns.empty()) return;
+            m_results.push_back(Result{std::move(name), std::move(unit), items_per_op, std::move(samples_ns)});
+        }
+
+        void print_json(std::ostream& out, std::string_view meta) const {
+            out << "{\n  \"meta\": " << meta << ",\n  \"benchmarks\": [";
+            for (size_t i = 0; i < m_results.size(); i++) {
+                const auto& r = m_results[i];
+                double median = r.median();
+                out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << r.name << "\", \"samples\": "
+                    << r.samples_ns.size() << ", \"median_ns\": " << median << ", \"p99_ns\": " << r.percentile(0.99)
+                    << ", \"unit\": \"" << r.unit << "\", \"items_per_op\": " << r.items_per_op
+                    << ", \"items_per_sec\": " << (median > 0 ? r.items_per_op * 1e9 / median : 0.0) << "}";
+            }
+            out << "\n  ]\n}\n";
+        }
+    };
+}
@@ -0,0 +1,269 @@
+#include "Benchmark.h"
+#include "CandidateIndex.h"
+#include "EntropyScorer.h"
+#include "FilterKernel.h"
+#include "PackedDictionary.h"
+#include "PatternKernel.h"
+#include "PatternMatrix.h"
+#include "Solver.h"
+#include "Sweep.h"
+#include "ThreadPool.h"
+#include "data/DictionaryLoader.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace std::chrono;
+
+constexpr auto help_message = R"(
+Usage: WordleSolverBench [--reps=N] [--warmup=N] [--filter=text] [--threads=N]
+Runs the micro and macro benchmarks whose name contains the filter text and prints median, p99 and throughput
+of each as JSON. Slow benchmarks (startup, sweeps) run a fifth of the repetitions.
+)"sv;
+
+#if defined(_WIN32)
+constexpr auto null_redirect = " > NUL"sv;
+#else
+constexpr auto null_redirect = " > /dev/null"sv;
+#endif
+
+namespace {
+    // a game played up to some turn: the board holds the feedback so far, the solver has picked the guesses so far
+    struct GameState {
+        Board board;
+        Solver solver;
+    };
+
+    // days still going after depth guesses, with the state right before the next one
+    std::vector<GameState> play_to_depth(const SolverContext& ctx, size_t depth) {
+        std::vector<GameState> states{};
+        for (size_t day = 0; day < ctx.solutions.size(); day++) {
+            GameState state{Board{ctx.solutions, day, ctx.patterns}, Solver{ctx}};
+            while (state.board.guesses() < depth && !state.board.solved())
+                state.board.guess(state.solver.next_guess(state.board));
+            if (!state.board.solved() && state.board.guesses() == depth) states.push_back(std::move(state));
+        }
+        return states;
+    }
+
+    bool parse_size(std::string_view value, size_t& out) {
+        auto res = std::from_chars(value.data(), value.data() + value.size(), out);
+        return res.ec == std::errc{} && res.ptr == value.data() + value.size();
+    }
+}
+
+int main(int argc, char** argv) {
+    // the built-in lists are constant-initialized, so the first call doesn't do more than any other
+    const auto first_call = steady_clock::now();
+    const auto dict = get_dictionary();
+    const duration<double, std::nano> first_call_ns = steady_clock::now() - first_call;
+    const auto solutions = get_solutions();
+
+    bench::Options opts{};
+    size_t n_threads = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg{argv[i]};
+        std::string_view name = arg.substr(0, arg.find('='));
+        std::string_view value = name.size() < arg.size() ? arg.substr(name.size() + 1) : ""sv;
+        bool ok = true;
+        if (name == "--reps"sv) {
+            ok = parse_size(value, opts.repetitions) && opts.repetitions > 0;
+        } else if (name == "--warmup"sv) {
+            ok = parse_size(value, opts.warmup);
+        } else if (name == "--filter"sv) {
+            opts.filter = value;
+        } else if (name == "--threads"sv) {
+            ok = parse_size(value, n_threads);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Invalid program arguments " << arg << '\n' << help_message << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+    const size_t slow_reps = std::max<size_t>(opts.repetitions / 5, 3);
+    bench::Suite suite{opts};
+
+    suite.record("get_dictionary_first_call", "words", static_cast<double>(dict.size()), {first_call_ns.count()});
+    {
+        // what loading a word list of the same size costs: the built-in one shuffled, then sorted again
+        std::vector<WordView> unsorted_words(dict.begin(), dict.end());
+        std::ranges::shuffle(unsorted_words, std::mt19937{42});
+        std::vector<WordView> copy{};
+        suite.run(
+        "dictionary_sort", "words", static_cast<double>(dict.size()),
+        [&] { copy.assign(unsorted_words.begin(), unsorted_words.end()); },
+        [&] {
+            sort_by_rating(copy);
+            bench::keep(copy.front());
+        });
+    }
+    if (suite.enabled("startup")) {
+        // whole process: loader, word list setup and exit, an empty range of days plays nothing
+        const std::string command = std::string{"\""} + WORDLESOLVER_EXE + "\" 0-0" + std::string{null_redirect};
+        suite.run("startup", "processes", 1.0, [&] { bench::keep(std::system(command.c_str())); }, slow_reps);
+    }
+
+    const PackedDictionary packed{dict};
+    const CandidateIndex index{packed};
+    const SolverContext ctx{solutions, dict, &packed, &index, nullptr, nullptr};
+
+    // a few first guesses against every solution
+    const std::array<size_t, 4> probes{0, 1, 100, 1000};
+    suite.run("board_guess", "guesses", static_cast<double>(solutions.size() * probes.size()), [&] {
+        for (size_t day = 0; day < solutions.size(); day++) {
+            Board b{solutions, day};
+            for (size_t p : probes)
+                b.guess({dict[p].word, false, p});
+            bench::keep(b.solved());
+        }
+    });
+    if (suite.enabled("board_guess_table")) {
+        const PatternMatrix patterns = PatternMatrix::build(dict, solutions);
+        suite.run("board_guess_table", "guesses", static_cast<double>(solutions.size() * probes.size()), [&] {
+            for (size_t day = 0; day < solutions.size(); day++) {
+                Board b{solutions, day, &patterns};
+                for (size_t p : probes)
+                    b.guess({dict[p].word, false, p});
+                bench::keep(b.solved());
+            }
+        });
+    }
+
+    if (suite.enabled("pattern_kernel")) {
+        // the first probes of the dictionary against every solution, a row block of the table build
+        std::vector<basic_word_code_t<default_word_size>> codes(solutions.size());
+        std::ranges::transform(solutions, codes.begin(), pack_word<default_word_size>);
+        std::vector<pattern_t> row(solutions.size());
+        const size_t n_probes = std::min<size_t>(dict.size(), 1024);
+        const double pairs = static_cast<double>(n_probes * solutions.size());
+        suite.run("pattern_kernel", "patterns", pairs, [&] {
+            for (size_t p = 0; p < n_probes; p++)
+                compute_patterns<default_word_size>(pack_word<default_word_size>(dict[p].word), codes, row.data());
+            bench::keep(row.front());
+        });
+        suite.run("pattern_kernel_scalar", "patterns", pairs, [&] {
+            for (size_t p = 0; p < n_probes; p++)
+                compute_patterns_scalar<default_word_size>(pack_word<default_word_size>(dict[p].word), codes,
+                                                           row.data());
+            bench::keep(row.front());
+        });
+    }
+
+    // the filters are measured mid-game: after two guesses, with the feedback of both taken in
+    std::vector<GameState> mid_game = play_to_depth(ctx, 2);
+    std::vector<FilterConstraints> constraints{};
+    for (auto& state : mid_game) {
+        state.board.guess(state.solver.next_guess(state.board));
+        constraints.push_back(state.solver.compile_constraints());
+    }
+    const size_t n_filtered = std::min<size_t>(mid_game.size(), 64);
+    const double filtered_words = static_cast<double>(n_filtered * dict.size());
+    suite.run("solver_filter", "words", filtered_words, [&] {
+        for (size_t i = 0; i < n_filtered; i++) {
+            SolverFilter filter{mid_game[i].solver};
+            size_t n = 0;
+            for (const auto& word : dict)
+                n += filter(word);
+            bench::keep(n);
+        }
+    });
+    std::vector<uint32_t> out(dict.size());
+    suite.run("filter_kernel", "words", filtered_words, [&] {
+        for (size_t i = 0; i < n_filtered; i++)
+            bench::keep(filter_words(packed, constraints[i], 0, dict.size(), out.data()));
+    });
+    suite.run("filter_kernel_scalar", "words", filtered_words, [&] {
+        for (size_t i = 0; i < n_filtered; i++)
+            bench::keep(filter_words_scalar(packed, constraints[i], 0, dict.size(), out.data()));
+    });
+    std::vector<CandidateIndex::block_t> live(index.blocks());
+    suite.run("index_narrow", "words", filtered_words, [&] {
+        for (size_t i = 0; i < n_filtered; i++) {
+            index.fill(live);
+            index.narrow(constraints[i], live);
+            bench::keep(live.front());
+        }
+    });
+    mid_game.clear();
+
+    // next_guess changes the solver, so every repetition starts again from fresh copies of the states
+    for (size_t depth = 0; depth < Board::max_guesses(); depth++) {
+        const std::string name = "next_guess_depth" + std::to_string(depth);
+        if (!suite.enabled(name)) continue;
+        const std::vector<GameState> states = play_to_depth(ctx, depth);
+        if (states.empty()) continue;
+        std::vector<GameState> work{};
+        suite.run(
+        name, "guesses", static_cast<double>(states.size()), [&] {
+            work.clear();
+            for (const auto& state : states)
+                work.push_back(state);
+        },
+        [&] {
+            for (auto& state : work)
+                bench::keep(state.solver.next_guess(state.board));
+        });
+    }
+
+    if (suite.enabled("entropy_opener")) {
+        // the scorer picks the opener by scoring every probe against every solution, the longest turn of a game
+        const PatternMatrix patterns = PatternMatrix::build(dict, solutions);
+        ThreadPool pool{n_threads};
+        const double probes = static_cast<double>(dict.size());
+        suite.run("entropy_opener", "probes", probes,
+                  [&] { bench::keep(EntropyScorer{patterns, dict, solutions}.opener()); }, slow_reps);
+        suite.run("entropy_opener_parallel", "probes", probes,
+                  [&] { bench::keep(EntropyScorer{patterns, dict, solutions, &pool}.opener()); }, slow_reps);
+        n_threads = pool.size();
+    }
+
+    const double games = static_cast<double>(solutions.size());
+    suite.run("sweep_sequential", "games", games,
+              [&] { bench::keep(solve_loop(ctx, 0, solutions.size(), BoardOutput::Quiet)); }, slow_reps);
+    suite.run("sweep_lockstep", "games", games, [&] { bench::keep(solve_lockstep(ctx, 0, solutions.size())); },
+              slow_reps);
+    if (suite.enabled("render_full") || suite.enabled("render_compact")) {
+        // every game played to its end, rendered into the same buffer a sweep writes out from
+        std::vector<GameState> finished{};
+        for (size_t day = 0; day < solutions.size(); day++) {
+            GameState state{Board{ctx.solutions, day, ctx.patterns}, Solver{ctx}};
+            while (!state.board.solved() && state.board.guesses() < state.board.max_guesses())
+                state.board.guess(state.solver.next_guess(state.board));
+            finished.push_back(std::move(state));
+        }
+        std::string out{};
+        auto render_all = [&](BoardOutput output) {
+            out.clear();
+            for (const auto& state : finished)
+                state.board.render(state.solver, out, output);
+            bench::keep(out.size());
+        };
+        suite.run("render_full", "games", games, [&] { render_all(BoardOutput::Full); });
+        suite.run("render_compact", "games", games, [&] { render_all(BoardOutput::Compact); });
+    }
+    if (suite.enabled("sweep_parallel") || suite.enabled("sweep_tree_parallel")) {
+        ThreadPool pool{n_threads};
+        suite.run("sweep_parallel", "games", games,
+                  [&] { bench::keep(solve_loop_parallel(ctx, 0, solutions.size(), pool)); }, slow_reps);
+        suite.run("sweep_tree_parallel", "games", games,
+                  [&] { bench::keep(solve_tree(ctx, 0, solutions.size(), &pool)); }, slow_reps);
+        n_threads = pool.size();
+    }
+    suite.run("sweep_tree", "games", games, [&] { bench::keep(solve_tree(ctx, 0, solutions.size(), nullptr)); },
+              slow_reps);
+
+    const std::string meta = "{\"repetitions\": " + std::to_string(opts.repetitions) + ", \"warmup\": " +
+                             std::to_string(opts.warmup) + ", \"threads\": " + std::to_string(n_threads) + "}";
+    suite.print_json(std::cout, meta);
+    return EXIT_SUCCESS;
+}
@@ -2,7 +2,7 @@
 
 using namespace std::string_view_literals;
 
-std::array<std::string_view, 2309> solutions{
+constinit const std::array<std::string_view, 2309> solutions{
 "cigar"sv, "rebut"sv, "sissy"sv, "humph"sv, "awake"sv, "blush"sv, "focal"sv, "evade"sv, "naval"sv, "serve"sv, "heath"sv,
 "dwarf"sv, "model"sv, "karma"sv, "stink"sv, "grade"sv, "quiet"sv, "bench"sv, "abate"sv, "feign"sv, "major"sv, "death"sv,
 "fresh"sv, "crust"sv, "stool"sv, "colon"sv, "abase"sv, "marry"sv, "react"sv, "batty"sv, "pride"sv, "floss"sv, "helix"sv,
@@ -215,7 +215,9 @@ std::array<std::string_view, 2309> solutions{
 "hydro"sv, "liege"sv, "octal"sv, "ombre"sv, "payer"sv, "sooth"sv, "unset"sv, "unlit"sv, "vomit"sv, "fanny"sv};
 
 
-std::array<WordView, 12972> words{
+namespace {
+    // as listed, sorted by the compiler below
+    constexpr std::array<WordView, 12972> unsorted_words{
 "abacs"_w, "nodal"_w, "psyop"_w, "coups"_w, "pewit"_w, "mazut"_w, "grapy"_w, "weans"_w, "khaki"_w, "ascon"_w, "gland"_w,
 "dries"_w, "goras"_w, "polys"_w, "pubes"_w, "ensue"_w, "wells"_w, "rheum"_w, "lowly"_w, "bills"_w, "spumy"_w, "nabob"_w,
 "iftar"_w, "gemot"_w, "snees"_w, "leeks"_w, "gorps"_w, "shogs"_w, "manus"_w, "volae"_w, "abrim"_w, "feers"_w, "umble"_w,
@@ -1395,4 +1397,7 @@ std::array<WordView, 12972> words{
 "smirk"_w, "saist"_w, "boras"_w, "flees"_w, "qanat"_w, "acais"_w, "prees"_w, "beare"_w, "fanga"_w, "manta"_w, "there"_w,
 "faced"_w, "teeth"_w, "chyle"_w, "naevi"_w, "lords"_w, "boozy"_w, "diota"_w, "herms"_w, "vital"_w, "cavas"_w, "rotos"_w,
 "ochry"_w, "danks"_w, "nubia"_w, "felon"_w, "skody"_w, "brose"_w, "lisks"_w, "stere"_w, "mesto"_w, "capex"_w, "fetwa"_w,
-"coven"_w, "giddy"_w, "conus"_w};
\ No newline at end of file
+"coven"_w, "giddy"_w, "conus"_w};
+}
+
+constinit const std::array<WordView, 12972> words = sorted_by_rating(unsorted_words);
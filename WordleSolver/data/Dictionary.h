@@ -4,5 +4,6 @@
 #include "DictionaryLoader.h"
 
 // extern because if I declared them in the .h file Intellisense dies horribly.
-extern std::array<std::string_view, 2309> solutions;
-extern std::array<WordView, 12972> words;
+// words is sorted by rating, as get_dictionary returns it
+extern const std::array<std::string_view, 2309> solutions;
+extern const std::array<WordView, 12972> words;
@@ -1,19 +1,35 @@
 #include "DictionaryLoader.h"
 #include "Dictionary.h"
 #include <algorithm>
+#include <utility>
 #include <ranges>
+#include <vector>
 
 namespace r = std::ranges;
 
-std::span<WordView> get_dictionary() {
-    static bool sorted = false;
-    if (!sorted) {
-        r::stable_sort(words, [](const WordView& lhs, const WordView& rhs) { return lhs.value > rhs.value; });
-        sorted = true;
-    }
-    return std::span{words.begin(), words.end()};
+void sort_by_rating(std::span<WordView> words, std::span<const double> ratings) {
+    // the ratings are sorted next to the word indices, the words are moved once at the end
+    std::vector<std::pair<double, uint32_t>> order(words.size());
+    for (size_t i = 0; i < words.size(); i++)
+        order[i] = {ratings[i], static_cast<uint32_t>(i)};
+    r::stable_sort(order, [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+    std::vector<WordView> sorted{};
+    sorted.reserve(words.size());
+    for (const auto& [rating, i] : order)
+        sorted.push_back(words[i]);
+    r::copy(sorted, words.begin());
 }
 
-std::span<std::string_view> get_solutions() {
-    return std::span{solutions.begin(), solutions.end()};
+void sort_by_rating(std::span<WordView> words) {
+    std::vector<double> ratings(words.size());
+    r::transform(words, ratings.begin(), [](const WordView& view) { return evaluate_word(view.word); });
+    sort_by_rating(words, ratings);
+}
+
+std::span<const WordView> get_dictionary() noexcept {
+    return words;
+}
+
+std::span<const std::string_view> get_solutions() noexcept {
+    return solutions;
 }
\ No newline at end of file
@@ -1,7 +1,11 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <numeric>
 #include <span>
 #include <string_view>
+#include <utility>
 #include "../Common.h"
 
 constexpr double evaluate_word(const std::string_view& word) {
@@ -77,18 +81,44 @@ constexpr WordMask construct_word_mask(const std::string_view& word) {
     return mask;
 }
 
+// A dictionary word and the letters it has, 24 bytes. Its rating only decides the order of the dictionary, so it isn't
+// kept: sort_by_rating computes it once per word while sorting. The word stays text because it is printed, sent to
+// clients and matched against the history; the hot loops read PackedDictionary (letter columns and masks) and the
+// packed codes instead, so a code in here would only be a third copy of the letters.
 struct WordView {
-    std::string_view word;
-    WordMask word_mask;
-    double value;
+    std::string_view word{};
+    WordMask word_mask = WordMask::NOLETTER;
 
-    constexpr WordView(std::string_view word_) :
-        word(word_), word_mask(construct_word_mask(word_)), value(evaluate_word(word_)) {}
+    constexpr WordView() = default;
+    constexpr WordView(std::string_view word_) : word(word_), word_mask(construct_word_mask(word_)) {}
 };
 
 constexpr WordView operator""_w(const char* ptr, size_t sz) {
     return WordView{std::string_view{ptr, sz}};
 }
 
-std::span<WordView> get_dictionary();
-std::span<std::string_view> get_solutions();
\ No newline at end of file
+// order of the dictionary: best rated (evaluate_word) first, equally rated words keep their order.
+// ratings[i] is the rating of words[i], the overload without them computes them
+void sort_by_rating(std::span<WordView> words, std::span<const double> ratings);
+void sort_by_rating(std::span<WordView> words);
+
+// sort_by_rating at compile time, for the built-in dictionary. The index breaks the ties, so the unstable sort gives
+// the order of the stable one
+template <size_t N>
+consteval std::array<WordView, N> sorted_by_rating(const std::array<WordView, N>& words) {
+    std::array<std::pair<double, uint32_t>, N> order{};
+    for (size_t i = 0; i < N; i++)
+        order[i] = {evaluate_word(words[i].word), static_cast<uint32_t>(i)};
+    std::sort(order.begin(), order.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first > rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
+    });
+    std::array<WordView, N> sorted{};
+    for (size_t i = 0; i < N; i++)
+        sorted[i] = words[order[i].second];
+    return sorted;
+}
+
+// the built-in lists, constant-initialized: the dictionary is sorted when the program is compiled, nothing runs at
+// startup and both can be read from any thread
+std::span<const WordView> get_dictionary() noexcept;
+std::span<const std::string_view> get_solutions() noexcept;
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "WordListFile.h"
+#include "../Pattern.h"
+#include "../Simd.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+    // below this many words rating them takes less than starting the threads
+    constexpr size_t parallel_rating_threshold = 1 << 15;
+
+#if WS_HAS_X86
+    WS_TARGET_AVX2 void find_newlines_avx2(const char* data, size_t size, std::vector<size_t>& out) {
+        const __m256i newline = _mm256_set1_epi8('\n');
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline)));
+            for (; mask != 0; mask &= mask - 1)
+                out.push_back(i + static_cast<size_t>(std::countr_zero(mask)));
+        }
+        for (; i < size; i++) {
+            if (data[i] == '\n') out.push_back(i);
+        }
+    }
+#endif
+
+    void find_newlines_scalar(const char* data, size_t size, std::vector<size_t>& out) {
+        for (const char* p = data; const void* nl = std::memchr(p, '\n', static_cast<size_t>(data + size - p));) {
+            p = static_cast<const char*>(nl);
+            out.push_back(static_cast<size_t>(p - data));
+            p++;
+        }
+    }
+
+    // offsets of every '\n' in the data, in order
+    void find_newlines(const char* data, size_t size, std::vector<size_t>& out) {
+#if WS_HAS_X86
+        static const bool avx2 = cpu_has_avx2();
+        if (avx2) {
+            find_newlines_avx2(data, size, out);
+            return;
+        }
+#endif
+        find_newlines_scalar(data, size, out);
+    }
+
+    bool is_word(std::string_view word) {
+        return word.size() >= min_word_size && word.size() <= max_word_size &&
+               std::ranges::all_of(word, [](char c) { return c >= 'a' && c <= 'z'; });
+    }
+}
+
+WordListFile::WordListFile(const std::filesystem::path& path) : m_file(path) {
+    const auto bytes = m_file.bytes();
+    const char* data = reinterpret_cast<const char*>(bytes.data());
+    std::vector<size_t> ends{};
+    ends.reserve(bytes.size() / (default_word_size + 1) + 1);
+    find_newlines(data, bytes.size(), ends);
+    // last line without a terminator
+    if (ends.empty() || ends.back() != bytes.size() - 1) ends.push_back(bytes.size());
+
+    m_words.reserve(ends.size());
+    size_t begin = 0;
+    for (size_t line = 0; line < ends.size(); line++) {
+        std::string_view word{data + begin, ends[line] - begin};
+        begin = ends[line] + 1;
+        if (!word.empty() && word.back() == '\r') word.remove_suffix(1);
+        if (word.empty()) continue;
+        auto error = [&](std::string_view what) {
+            return std::runtime_error(path.string() + ":" + std::to_string(line + 1) + ": \"" + std::string{word} +
+                                      "\" " + std::string{what});
+        };
+        if (!is_word(word)) {
+            throw error("is not a lowercase word of " + std::to_string(min_word_size) + " to " +
+                        std::to_string(max_word_size) + " letters");
+        }
+        if (!m_words.empty() && word.size() != m_words.front().size()) {
+            throw error("has " + std::to_string(word.size()) + " letters, the first word has " +
+                        std::to_string(m_words.front().size()));
+        }
+        m_words.push_back(word);
+    }
+    if (m_words.empty()) throw std::runtime_error(path.string() + " has no words");
+}
+
+std::vector<WordView> make_dictionary(std::span<const std::string_view> words) {
+    if (words.empty()) return {};
+    std::vector<WordView> dict(words.size(), WordView{words.front()});
+    std::vector<double> ratings(words.size());
+    auto rate = [&dict, &ratings, words](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            dict[i] = WordView{words[i]};
+            ratings[i] = evaluate_word(words[i]);
+        }
+    };
+    if (words.size() < parallel_rating_threshold) {
+        rate(0, words.size());
+    } else {
+        size_t n_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        size_t per_thread = (words.size() + n_threads - 1) / n_threads;
+        std::vector<std::jthread> threads{};
+        threads.reserve(n_threads);
+        for (size_t start = 0; start < words.size(); start += per_thread)
+            threads.emplace_back(rate, start, std::min(words.size(), start + per_thread));
+    }
+    sort_by_rating(dict, ratings);
+    return dict;
+}
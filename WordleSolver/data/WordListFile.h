@@ -0,0 +1,24 @@
+#pragma once
+#include "../MappedFile.h"
+#include "DictionaryLoader.h"
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// Word list read from a plain text file, one word per line ("\n" or "\r\n" terminated), blank lines are skipped.
+// The words are views into the mapped file, so the object has to outlive everything built from them.
+class WordListFile {
+    MappedFile m_file;
+    std::vector<std::string_view> m_words{};
+
+    public:
+    // throws if the file can't be mapped, a line isn't a lowercase word of a length the solver handles or the words
+    // don't all have the same length
+    explicit WordListFile(const std::filesystem::path& path);
+
+    std::span<const std::string_view> words() const noexcept { return m_words; }
+};
+
+// the words rated and sorted like the built-in list, large lists are rated in parallel
+std::vector<WordView> make_dictionary(std::span<const std::string_view> words);
@@ -0,0 +1,139 @@
+#include "Board.h"
+#include "CandidateIndex.h"
+#include "FilterKernel.h"
+#include "PackedDictionary.h"
+#include "PatternKernel.h"
+#include "Solver.h"
+#include "data/DictionaryLoader.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std::string_view_literals;
+
+constexpr auto help_message = R"(
+Usage: WordleSolverTests <test>
+Runs one of the checks below, prints the first mismatch and fails if there is one.
+pattern_kernel      compute_patterns and compute_patterns_scalar against Board::guess for every dictionary word
+                    against every solution, and for every pair of words drawn from a few letters at every word size
+filter_kernel       filter_words and filter_words_scalar against SolverFilter for the solver state of every day
+                    after each of its first guesses, over the whole dictionary and over a range that isn't aligned
+)"sv;
+
+namespace {
+    // the pattern kernels against Board::guess for every guess and solution, prints the first mismatch
+    template <size_t N>
+    bool check_pattern_kernel(std::span<const std::string_view> guesses, std::span<const std::string_view> solutions) {
+        std::vector<basic_word_code_t<N>> codes(solutions.size());
+        std::ranges::transform(solutions, codes.begin(), pack_word<N>);
+        std::vector<basic_pattern_t<N>> out(solutions.size());
+        std::vector<basic_pattern_t<N>> out_scalar(solutions.size());
+        for (size_t g = 0; g < guesses.size(); g++) {
+            compute_patterns<N>(pack_word<N>(guesses[g]), codes, out.data());
+            compute_patterns_scalar<N>(pack_word<N>(guesses[g]), codes, out_scalar.data());
+            for (size_t s = 0; s < solutions.size(); s++) {
+                BasicBoard<N> board{solutions, s};
+                board.guess({guesses[g], false, g});
+                const auto expected = encode_pattern(board.board()[0]);
+                if (out[s] != expected || out_scalar[s] != expected) {
+                    std::cerr << "Pattern kernel mismatch: " << guesses[g] << " against " << solutions[s] << '\n';
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // every word of N letters drawn from a few letters, so that every way duplicates can line up comes up
+    template <size_t N>
+    bool check_pattern_kernel_duplicates() {
+        constexpr char letters[]{'a', 'e', 'z'};
+        std::vector<std::string> words(pow3(N), std::string(N, 'a'));
+        for (size_t w = 0; w < words.size(); w++) {
+            for (size_t i = 0, rest = w; i < N; i++, rest /= 3)
+                words[w][i] = letters[rest % 3];
+        }
+        const std::vector<std::string_view> views(words.begin(), words.end());
+        return check_pattern_kernel<N>(views, views);
+    }
+
+    bool test_pattern_kernel() {
+        const auto dict = get_dictionary();
+        const auto solutions = get_solutions();
+        std::vector<std::string_view> guesses(dict.size());
+        std::ranges::transform(dict, guesses.begin(), [](const WordView& w) { return w.word; });
+        bool ok = check_pattern_kernel<default_word_size>(guesses, solutions);
+#define WS_CHECK_PATTERN_KERNEL(N) ok = ok && check_pattern_kernel_duplicates<N>();
+        WS_FOR_EACH_WORD_SIZE(WS_CHECK_PATTERN_KERNEL)
+#undef WS_CHECK_PATTERN_KERNEL
+        return ok;
+    }
+
+    // both filter kernels against SolverFilter on [begin, end), prints the first mismatch. The kernels leave the
+    // words already guessed to the solver, so those are left out of the comparison
+    bool check_filter_kernel(const PackedDictionary& packed, std::span<const WordView> dict, Solver& solver,
+                             size_t turns, size_t day, size_t begin, size_t end) {
+        const auto guessed = [&](uint32_t i) {
+            for (size_t turn = 0; turn < turns; turn++) {
+                if (solver.history(turn) == dict[i].word) return true;
+            }
+            return false;
+        };
+        const FilterConstraints constraints = solver.compile_constraints();
+        std::vector<uint32_t> out(end - begin);
+        std::vector<uint32_t> out_scalar(end - begin);
+        out.resize(filter_words(packed, constraints, begin, end, out.data()));
+        out_scalar.resize(filter_words_scalar(packed, constraints, begin, end, out_scalar.data()));
+        std::erase_if(out, guessed);
+        std::erase_if(out_scalar, guessed);
+        std::vector<uint32_t> expected{};
+        SolverFilter filter{solver};
+        for (uint32_t i = static_cast<uint32_t>(begin); i < end; i++) {
+            if (!guessed(i) && filter(dict[i])) expected.push_back(i);
+        }
+        if (out != expected || out_scalar != expected) {
+            std::cerr << "Filter kernel mismatch on day " << day << " on [" << begin << ", " << end << ")\n";
+            return false;
+        }
+        return true;
+    }
+
+    bool test_filter_kernel() {
+        const auto dict = get_dictionary();
+        const auto solutions = get_solutions();
+        const PackedDictionary packed{dict};
+        const CandidateIndex index{packed};
+        const SolverContext ctx{solutions, dict, &packed, &index, nullptr, nullptr};
+        for (size_t day = 0; day < solutions.size(); day++) {
+            Board board{solutions, day};
+            Solver solver{ctx};
+            while (!board.solved() && board.guesses() < 3) {
+                board.guess(solver.next_guess(board));
+                if (!check_filter_kernel(packed, dict, solver, board.guesses(), day, 0, dict.size()) ||
+                    !check_filter_kernel(packed, dict, solver, board.guesses(), day, 7, dict.size() - 5))
+                    return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::string_view test = argc == 2 ? argv[1] : ""sv;
+    bool ok = false;
+    if (test == "pattern_kernel"sv) {
+        ok = test_pattern_kernel();
+    } else if (test == "filter_kernel"sv) {
+        ok = test_filter_kernel();
+    } else {
+        std::cerr << "Invalid program arguments\n" << help_message << '\n';
+        return EXIT_FAILURE;
+    }
+    if (!ok) return EXIT_FAILURE;
+    std::cout << test << " passed\n";
+    return EXIT_SUCCESS;
+}